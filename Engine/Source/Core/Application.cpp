@@ -1,6 +1,7 @@
 #include "Application.h"
 #include "Networking/Server.h"
 #include <chrono>
+#include <algorithm>
 #include <iostream>
 #include <csignal>
 
@@ -16,9 +17,6 @@ Application::Application()
 
     // Initialize the input handler object
     input = Input();
-
-    // Initialize the physics class object
-    physics = Physics();
 }
 
 Application::~Application() {
@@ -61,9 +59,9 @@ void Application::Init() {
 void Application::PhysicsThreadFunction() {
     while (running) {
         // Update physics system
-        entityManager.UpdatePhysics([this](std::vector<Entity>& entities) {
+        entityManager.UpdatePhysics([this](EntityStorage& storage) {
             float effectiveTimestep = timeline.CalculateEffectiveTime(FIXED_TIMESTEP);
-            physics.UpdatePhysics(entities, effectiveTimestep);
+            physics.UpdatePhysics(storage, effectiveTimestep);
         });
 
         // Sleep to maintain 60 Hz update rate
@@ -115,9 +113,20 @@ void Application::RenderThreadFunction() {
         // Update timeline
         timeline.Update(deltaTime);
 
+        // Apply the server's state for this frame (client mode)
+        if (currentMode == NetworkMode::CLIENT) {
+            networkManager.UpdateEntities(deltaTime);
+        }
+
+        // Queue collision events from the physics steps since the last frame
+        physics.FlushContactEvents(eventManager);
+
         // Update game logic
         gameRef->OnUpdate(effectiveDeltaTime);
 
+        // Publish this frame's entity state for rendering
+        entityManager.PublishFrameState();
+
         // Update replay manager
         replayManager.Update(eventManager, effectiveDeltaTime);
 
@@ -177,12 +186,12 @@ void Application::NetworkThreadFunction() {
         // Update networking system
         networkManager.Update();
 
-        // Sleep duration scaled by timeline to simulate different update rates
+        // Wait for the server's next push, at most an interval scaled by timeline to simulate different update rates
         float baseIntervalMs = 16.0f;
         float timeScale = timeline.GetTimeScale();
         float adjustedInterval = baseIntervalMs / timeScale;
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(adjustedInterval)));
+        networkManager.WaitForServer(static_cast<int>(adjustedInterval));
     }
 }
 
@@ -299,6 +308,11 @@ void Application::RunServer(GameInterface* game, bool headless) {
     // Enable headless mode only for dedicated servers
     server.GetEntityManager().SetHeadlessMode(headless);
 
+    // Dedicated servers have no render thread, so the physics step can use every core
+    if (headless) {
+        server.GetPhysics().SetWorkerCount(std::max(1u, std::thread::hardware_concurrency()));
+    }
+
     // Set renderer for listen-server entity manager
     if (headless) {
         // Initialize game logic
@@ -445,6 +459,10 @@ void Application::RunClient(const std::string& serverAddress, GameInterface* gam
 
     // Initialize NetworkManager and connect to server
     networkManager.SetEntityManager(&entityManager);
+    networkManager.SetPhysics(&physics);
+    networkManager.SetPlayerInputHandler([game](uint32_t entityID, const InputState& input, float deltaTime) {
+        return game->OnPlayerInput(entityID, input, deltaTime);
+    });
     if (!networkManager.Connect(serverAddress)) {
         std::cout << "Failed to connect to server at " << serverAddress << "\n";
         return;
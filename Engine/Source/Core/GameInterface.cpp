@@ -162,41 +162,49 @@ float GameInterface::GetGravity(){
 
 void GameInterface::ApplyForce(uint32_t entityID, float forceX, float forceY) {
     if (entityManagerRef && physicsRef) {
-        Entity* entity = entityManagerRef->GetEntityByID(entityID);
-        if (entity) {
-            physicsRef->ApplyForce(*entity, Vec2(forceX, forceY));
-        }
+        entityManagerRef->ModifyEntity(entityID, [this, forceX, forceY](Entity& entity) {
+            physicsRef->ApplyForce(entity, Vec2(forceX, forceY));
+        });
     }
 }
 
 void GameInterface::ApplyImpulse(uint32_t entityID, float impulseX, float impulseY) {
     if (entityManagerRef && physicsRef) {
-        Entity* entity = entityManagerRef->GetEntityByID(entityID);
-        if (entity) {
-            physicsRef->ApplyImpulse(*entity, Vec2(impulseX, impulseY));
-        }
+        entityManagerRef->ModifyEntity(entityID, [this, impulseX, impulseY](Entity& entity) {
+            physicsRef->ApplyImpulse(entity, Vec2(impulseX, impulseY));
+        });
     }
 }
 
 void GameInterface::SetVelocity(uint32_t entityID, float velX, float velY) {
     if (entityManagerRef && physicsRef) {
-        Entity* entity = entityManagerRef->GetEntityByID(entityID);
-        if (entity) {
-            physicsRef->SetVelocity(*entity, Vec2(velX, velY));
-        }
+        entityManagerRef->ModifyEntity(entityID, [this, velX, velY](Entity& entity) {
+            physicsRef->SetVelocity(entity, Vec2(velX, velY));
+        });
     }
 }
 
 Vec2 GameInterface::GetVelocity(uint32_t entityID) {
     if (entityManagerRef) {
-        Entity* entity = entityManagerRef->GetEntityByID(entityID);
-        if (entity) {
-            return entity->velocity;
-        }
+        return entityManagerRef->GetVelocity(entityID);
     }
     return Vec2::zero();
 }
 
+std::vector<uint32_t> GameInterface::QueryArea(const Vec2& min, const Vec2& max) {
+    if (physicsRef) {
+        return physicsRef->QueryArea(min, max);
+    }
+    return {};
+}
+
+bool GameInterface::Raycast(const Vec2& origin, const Vec2& direction, float maxDistance, RaycastHit& hit) {
+    if (physicsRef) {
+        return physicsRef->Raycast(origin, direction, maxDistance, hit);
+    }
+    return false;
+}
+
 void GameInterface::SetPosition(uint32_t entityID, float newX, float newY) {
     if (entityManagerRef) {
         entityManagerRef->SetPosition(entityID, Vec2(newX, newY));
@@ -205,10 +213,7 @@ void GameInterface::SetPosition(uint32_t entityID, float newX, float newY) {
 
 Vec2 GameInterface::GetPosition(uint32_t entityID) {
     if (entityManagerRef) {
-        Entity* entity = entityManagerRef->GetEntityByID(entityID);
-        if (entity) {
-            return entity->position;
-        }
+        return entityManagerRef->GetPosition(entityID);
     }
     return Vec2::zero();
 }
@@ -409,9 +414,9 @@ void GameInterface::RegisterPlayerEntity(uint32_t clientID, uint32_t entityID) {
     }
 }
 
-void GameInterface::SendInputToServer(const std::unordered_map<std::string, bool>& buttons) {
+void GameInterface::SendInputToServer(const InputState& input) {
     if (networkManagerRef) {
-        networkManagerRef->SendInput(buttons);
+        networkManagerRef->SendInput(input);
     }
 }
 
@@ -422,6 +427,12 @@ uint32_t GameInterface::GetLocalClientId() {
     return 0;
 }
 
+void GameInterface::SetNetworkConditions(const NetworkConditions& conditions) {
+    if (networkManagerRef) {
+        networkManagerRef->SetNetworkConditions(conditions);
+    }
+}
+
 uint32_t GameInterface::GetLocalPlayerEntity() {
     if (networkManagerRef) {
         return networkManagerRef->GetLocalPlayerEntity();
@@ -466,19 +477,20 @@ void GameInterface::Raise()
 
 void GameInterface::BroadcastEntitySpawn(uint32_t entityID, uint32_t ownerClientID, uint32_t excludeClientID) {
     if (serverRef && entityManagerRef) {
-        Entity* entity = entityManagerRef->GetEntityByID(entityID);
-        if (entity) {
-            EntitySpawnInfo spawnInfo;
-            spawnInfo.entityID = entity->ID;
-            spawnInfo.spritePath = entity->spritePath;
-            spawnInfo.totalFrames = entity->totalFrames;
-            spawnInfo.fps = entity->fps;
-            spawnInfo.position = entity->position;
-            spawnInfo.scale = entity->scale;
-            spawnInfo.rotation = entity->rotation;
-            spawnInfo.physEnabled = entity->physApplied;
-            spawnInfo.colliderType = static_cast<int>(entity->collider.type);
+        EntitySpawnInfo spawnInfo;
+        bool found = entityManagerRef->GetEntityProperty(entityID, [&spawnInfo](const Entity& entity) {
+            spawnInfo.entityID = entity.ID;
+            spawnInfo.spritePath = entity.spritePath;
+            spawnInfo.totalFrames = entity.totalFrames;
+            spawnInfo.fps = entity.fps;
+            spawnInfo.position = entity.position;
+            spawnInfo.scale = entity.scale;
+            spawnInfo.rotation = entity.rotation;
+            spawnInfo.physEnabled = entity.physApplied;
+            spawnInfo.colliderType = static_cast<int>(entity.collider.type);
+        });
 
+        if (found) {
             serverRef->BroadcastEntitySpawn(spawnInfo, ownerClientID, excludeClientID);
         }
     }
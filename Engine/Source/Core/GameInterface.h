@@ -33,6 +33,12 @@ public:
     virtual void OnClientConnected(uint32_t clientID) {}
     virtual void OnClientDisconnected(uint32_t clientID) {}
 
+    // Optional callback applying a client's input to its player entity, once per server tick before physics
+    // Clients run it too to predict their own player ahead of the server and replay it when corrected, so it
+    // should only change the entity, through the helpers below (SetVelocity, ApplyForce, ...)
+    // Return true if the input was applied; returning false leaves the player to the server (no prediction)
+    virtual bool OnPlayerInput(uint32_t /*entityID*/, const InputState& /*input*/, float /*deltaTime*/) { return false; }
+
     // Set the internal renderer reference (for use in the engine core only)
     void SetRenderer(Renderer* renderer) { this->rendererRef = renderer; }
     // Set the internal input system reference (for use in the engine core only)
@@ -115,6 +121,10 @@ protected:
     void SetVelocity(uint32_t entityID, float velX, float velY);
     // Gets an entity's velocity
     Vec2 GetVelocity(uint32_t entityID);
+    // Returns the entities whose collision bounds overlap an area
+    std::vector<uint32_t> QueryArea(const Vec2& min, const Vec2& max);
+    // Casts a ray against entity collision bounds, reporting the closest hit
+    bool Raycast(const Vec2& origin, const Vec2& direction, float maxDistance, RaycastHit& hit);
     // Sets an entity's position
     void SetPosition(uint32_t entityID, float newX, float newY);
     // Gets an entity's position
@@ -198,12 +208,19 @@ protected:
     // Broadcasts entity despawns to connected clients
     void BroadcastEntityDespawn(uint32_t entityID, uint32_t excludeClientID = 0);
 
+    // Registers a named button action for InputState, returning its ID (the client and server must register
+    // the same actions in the same order, e.g. in OnStart)
+    InputActionID RegisterButtonAction(const std::string& name) { return InputActions::RegisterButton(name); }
+    // Registers a named axis action for InputState, returning its ID
+    InputActionID RegisterAxisAction(const std::string& name) { return InputActions::RegisterAxis(name); }
     // Sends client input states to the server
-    void SendInputToServer(const std::unordered_map<std::string, bool>& buttons);
+    void SendInputToServer(const InputState& input);
     // Gets the local player's client ID
     uint32_t GetLocalClientId();
     // Gets the local player's entity ID
     uint32_t GetLocalPlayerEntity();
+    // Simulates network conditions on the client's connection (see NetworkConditions::Parse for a text form)
+    void SetNetworkConditions(const NetworkConditions& conditions);
 
     // Registers an Event
     void Register(int type, Event e);
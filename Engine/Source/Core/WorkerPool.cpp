@@ -0,0 +1,94 @@
+#include "WorkerPool.h"
+#include <algorithm>
+
+namespace RiverCore {
+
+WorkerPool::WorkerPool(size_t workerCount) {
+    for (size_t i = 1; i < workerCount; ++i) {
+        threads.emplace_back(&WorkerPool::WorkerThread, this, i);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        stopping = true;
+    }
+    workCondition.notify_all();
+
+    for (std::thread& thread : threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+void WorkerPool::ParallelFor(size_t count, size_t minChunkSize, const RangeTask& task) {
+    if (count == 0) {
+        return;
+    }
+
+    // Run small loops (or a pool without threads) inline
+    size_t workerCount = GetWorkerCount();
+    minChunkSize = std::max<size_t>(minChunkSize, 1);
+    if (workerCount == 1 || count <= minChunkSize) {
+        task(0, count, 0);
+        return;
+    }
+
+    // A few chunks per worker evens out uneven chunk costs
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        currentTask = &task;
+        taskCount = count;
+        chunkSize = std::max(minChunkSize, (count + workerCount * 4 - 1) / (workerCount * 4));
+        nextChunk.store(0);
+        activeWorkers = threads.size();
+        ++generation;
+    }
+    workCondition.notify_all();
+
+    // The calling thread works too
+    RunChunks(0);
+
+    // Wait for the workers to finish their last chunks
+    std::unique_lock<std::mutex> lock(poolMutex);
+    doneCondition.wait(lock, [this] { return activeWorkers == 0; });
+    currentTask = nullptr;
+}
+
+void WorkerPool::WorkerThread(size_t workerIndex) {
+    size_t seenGeneration = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(poolMutex);
+            workCondition.wait(lock, [this, seenGeneration] { return stopping || generation != seenGeneration; });
+            if (stopping) {
+                return;
+            }
+            seenGeneration = generation;
+        }
+
+        RunChunks(workerIndex);
+
+        {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            --activeWorkers;
+        }
+        doneCondition.notify_one();
+    }
+}
+
+void WorkerPool::RunChunks(size_t workerIndex) {
+    while (true) {
+        size_t begin = nextChunk.fetch_add(chunkSize);
+        if (begin >= taskCount) {
+            return;
+        }
+        size_t end = std::min(begin + chunkSize, taskCount);
+        (*currentTask)(begin, end, workerIndex);
+    }
+}
+
+}
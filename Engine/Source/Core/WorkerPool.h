@@ -0,0 +1,61 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <cstddef>
+
+namespace RiverCore {
+
+// Fixed pool of worker threads for data-parallel loops
+// The calling thread takes part in every loop, so a pool created for N workers runs N - 1 threads
+class WorkerPool {
+public:
+    // Loop body: processes the range [begin, end) on the worker with the given index (0 is the calling thread)
+    using RangeTask = std::function<void(size_t begin, size_t end, size_t workerIndex)>;
+
+    explicit WorkerPool(size_t workerCount);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Returns the number of workers (including the calling thread)
+    size_t GetWorkerCount() const { return threads.size() + 1; }
+
+    // Splits [0, count) into chunks of at least minChunkSize and runs them across the workers, blocking until done
+    void ParallelFor(size_t count, size_t minChunkSize, const RangeTask& task);
+
+private:
+    // Worker threads
+    std::vector<std::thread> threads;
+    // Mutex and condition variables for dispatching loops
+    std::mutex poolMutex;
+    std::condition_variable workCondition;
+    std::condition_variable doneCondition;
+    // Incremented for every dispatched loop so sleeping workers notice new work
+    size_t generation = 0;
+    // Number of worker threads still running the current loop
+    size_t activeWorkers = 0;
+    // Stop flag for shutting down the pool
+    bool stopping = false;
+
+    // Current loop
+    const RangeTask* currentTask = nullptr;
+    size_t taskCount = 0;
+    size_t chunkSize = 1;
+    std::atomic<size_t> nextChunk{0};
+
+    // Worker thread function
+    void WorkerThread(size_t workerIndex);
+    // Claims and runs chunks of the current loop until none are left
+    void RunChunks(size_t workerIndex);
+};
+
+}
+
+#endif
@@ -24,12 +24,21 @@ enum EventType
     EVENT_TYPE_CLEAR_REPLAY
 };
 
+// Phase of a collision event
+enum ContactPhase
+{
+    CONTACT_BEGIN,      // The entities started touching this step
+    CONTACT_STAY,       // The entities were already touching
+    CONTACT_END         // The entities stopped touching (or one of them was removed)
+};
+
 // Data payload for events
 struct EventData {
     uint32_t entityID = 0;              // Primary entity involved
     uint32_t secondaryEntityID = 0;     // For collisions (other entity)
     Vec2 position = Vec2::zero();       // For spawn positions
     int collisionSide = 0;              // Collision direction
+    ContactPhase contactPhase = CONTACT_BEGIN;  // For collisions (begin, stay or end)
     std::unordered_map<std::string, bool> inputButtons;  // For input events
     int keyframeInterval = 1;          // For replay recording (seconds between keyframes)
 
@@ -95,6 +104,12 @@ public:
         eventMap.erase(type);
     }
 
+    // Returns whether any handler is registered for an event type
+    bool HasHandlers(int type) const {
+        auto it = eventMap.find(type);
+        return it != eventMap.end() && !it->second.empty();
+    }
+
     // Pushes event to the queue with data and optional timestamp
     // If timestamp < 0, uses current time (immediate processing)
     // If timestamp >= 0, event is scheduled for that time (delayed event)
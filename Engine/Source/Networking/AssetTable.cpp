@@ -0,0 +1,41 @@
+#include "AssetTable.h"
+
+namespace RiverCore {
+
+uint32_t AssetTable::Register(const std::string& path) {
+    if (path.empty()) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = ids.find(path);
+    if (it != ids.end()) {
+        return it->second;
+    }
+
+    paths.push_back(path);
+    uint32_t id = static_cast<uint32_t>(paths.size());
+    ids.emplace(path, id);
+    count = id;
+    return id;
+}
+
+AssetTableUpdate AssetTable::GetUpdate(uint32_t knownCount) const {
+    AssetTableUpdate update;
+    update.firstID = knownCount + 1;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (knownCount < paths.size()) {
+        update.paths.assign(paths.begin() + knownCount, paths.end());
+    }
+    return update;
+}
+
+void AssetTable::Clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    ids.clear();
+    paths.clear();
+    count = 0;
+}
+
+}
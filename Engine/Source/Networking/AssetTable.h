@@ -0,0 +1,38 @@
+#ifndef ASSETTABLE_H
+#define ASSETTABLE_H
+
+#include "NetworkProtocol.h"
+#include <unordered_map>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+namespace RiverCore {
+
+// Sprite paths replicated to clients, each assigned a compact ID on first use, so spawns reference an ID
+// instead of repeating the path
+// IDs start at 1 and are assigned in order and never reused, so a client that was sent the first N paths
+// can resolve every ID up to N. Thread-safe.
+class AssetTable {
+public:
+    // Returns the ID of a path, assigning the next one on first use (0 for an empty path)
+    uint32_t Register(const std::string& path);
+    // Returns the number of paths registered
+    uint32_t GetCount() const { return count.load(); }
+    // Returns the paths registered after the first knownCount ones
+    AssetTableUpdate GetUpdate(uint32_t knownCount) const;
+    // Forgets every path
+    void Clear();
+
+private:
+    std::unordered_map<std::string, uint32_t> ids;
+    std::vector<std::string> paths;     // By ID - 1
+    std::atomic<uint32_t> count{0};
+    mutable std::mutex mutex;
+};
+
+}
+
+#endif
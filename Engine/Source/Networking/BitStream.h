@@ -0,0 +1,175 @@
+#ifndef BITSTREAM_H
+#define BITSTREAM_H
+
+#include <string>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+namespace RiverCore {
+
+// Fixed-point encoding of a float range: values are clamped to [min, max] and stored as whole steps of
+// resolution, using just enough bits for the range. A resolution of zero (or less) keeps the raw 32-bit float.
+struct QuantizedRange {
+    float min = 0.0f;
+    float max = 0.0f;
+    float resolution = 0.0f;
+
+    QuantizedRange() = default;
+    QuantizedRange(float min, float max, float resolution) : min(min), max(max), resolution(resolution) {}
+
+    // Returns true if values are stored as raw floats
+    bool IsExact() const { return !(resolution > 0.0f) || !(max > min); }
+
+    // Returns the number of bits one value takes
+    int Bits() const {
+        if (IsExact()) {
+            return 32;
+        }
+        uint64_t steps = Steps();
+        int bits = 0;
+        while (bits < 32 && (steps >> bits) != 0) {
+            ++bits;
+        }
+        return bits;
+    }
+
+    // Converts a value to its stored form
+    uint32_t Quantize(float value) const {
+        if (IsExact()) {
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+        if (!(value > min)) {
+            return 0;  // Also catches NaN
+        }
+        if (value >= max) {
+            return static_cast<uint32_t>(Steps());
+        }
+        uint64_t quantized = static_cast<uint64_t>(std::llround((static_cast<double>(value) - min) / resolution));
+        return static_cast<uint32_t>(quantized < Steps() ? quantized : Steps());
+    }
+
+    // Converts a stored form back to a value
+    float Dequantize(uint32_t quantized) const {
+        if (IsExact()) {
+            float value;
+            std::memcpy(&value, &quantized, sizeof(value));
+            return value;
+        }
+        return min + static_cast<float>(quantized) * resolution;
+    }
+
+private:
+    uint64_t Steps() const {
+        double steps = std::ceil((static_cast<double>(max) - min) / resolution);
+        return steps < 4294967295.0 ? static_cast<uint64_t>(steps) : 4294967295u;
+    }
+};
+
+// Packs values of arbitrary bit width into a byte buffer, least significant bit first
+class BitWriter {
+public:
+    explicit BitWriter(std::string& buffer) : buffer(buffer) {}
+    ~BitWriter() { Flush(); }
+
+    // Writes the low bits of a value (bits may be 0 to 32)
+    void WriteBits(uint32_t value, int bits) {
+        if (bits <= 0) {
+            return;
+        }
+        if (bits < 32) {
+            value &= (1u << bits) - 1u;
+        }
+        scratch |= static_cast<uint64_t>(value) << scratchBits;
+        scratchBits += bits;
+        while (scratchBits >= 8) {
+            buffer.push_back(static_cast<char>(scratch & 0xFF));
+            scratch >>= 8;
+            scratchBits -= 8;
+        }
+    }
+
+    void WriteBool(bool value) { WriteBits(value ? 1u : 0u, 1); }
+
+    // Writes an unsigned value using a 6-bit length prefix followed by its significant bits
+    // (small values such as ID gaps or counters stay small)
+    void WriteVarBits(uint32_t value) {
+        int bits = 0;
+        while (bits < 32 && (value >> bits) != 0) {
+            ++bits;
+        }
+        WriteBits(static_cast<uint32_t>(bits), 6);
+        WriteBits(value, bits);
+    }
+
+    void WriteQuantized(float value, const QuantizedRange& range) { WriteBits(range.Quantize(value), range.Bits()); }
+
+    // Writes any partial byte; called automatically on destruction
+    void Flush() {
+        if (scratchBits > 0) {
+            buffer.push_back(static_cast<char>(scratch & 0xFF));
+            scratch = 0;
+            scratchBits = 0;
+        }
+    }
+
+private:
+    std::string& buffer;
+    uint64_t scratch = 0;
+    int scratchBits = 0;
+};
+
+// Reads values written by BitWriter
+// Reading past the end returns zero and marks the reader as failed, so callers can check once at the end
+class BitReader {
+public:
+    BitReader(const char* data, size_t size) : data(reinterpret_cast<const uint8_t*>(data)), size(size) {}
+
+    uint32_t ReadBits(int bits) {
+        if (bits <= 0) {
+            return 0;
+        }
+        while (scratchBits < bits) {
+            if (offset >= size) {
+                failed = true;
+                return 0;
+            }
+            scratch |= static_cast<uint64_t>(data[offset++]) << scratchBits;
+            scratchBits += 8;
+        }
+        uint32_t value = static_cast<uint32_t>(scratch & ((bits < 32) ? ((1ull << bits) - 1) : 0xFFFFFFFFull));
+        scratch >>= bits;
+        scratchBits -= bits;
+        return value;
+    }
+
+    bool ReadBool() { return ReadBits(1) != 0; }
+
+    uint32_t ReadVarBits() {
+        int bits = static_cast<int>(ReadBits(6));
+        if (bits > 32) {
+            failed = true;
+            return 0;
+        }
+        return ReadBits(bits);
+    }
+
+    float ReadQuantized(const QuantizedRange& range) { return range.Dequantize(ReadBits(range.Bits())); }
+
+    bool Failed() const { return failed; }
+
+private:
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    size_t offset = 0;
+    uint64_t scratch = 0;
+    int scratchBits = 0;
+    bool failed = false;
+};
+
+}
+
+#endif
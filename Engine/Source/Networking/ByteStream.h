@@ -0,0 +1,160 @@
+#ifndef BYTESTREAM_H
+#define BYTESTREAM_H
+
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+namespace RiverCore {
+
+// Appends little-endian values to a byte buffer
+// Floats are written as their raw IEEE-754 bits so they round-trip exactly
+class ByteWriter {
+public:
+    explicit ByteWriter(std::string& buffer) : buffer(buffer) {}
+
+    void WriteU8(uint8_t value) { buffer.push_back(static_cast<char>(value)); }
+    void WriteU16(uint16_t value) { WriteLE(value, 2); }
+    void WriteU32(uint32_t value) { WriteLE(value, 4); }
+    void WriteU64(uint64_t value) { WriteLE(value, 8); }
+    void WriteI32(int32_t value) { WriteLE(static_cast<uint32_t>(value), 4); }
+    void WriteBool(bool value) { WriteU8(value ? 1 : 0); }
+
+    void WriteF32(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        WriteU32(bits);
+    }
+
+    // Writes a string as a 16-bit length followed by its bytes (longer strings are truncated)
+    void WriteString(const std::string& value) {
+        size_t length = value.size() < 0xFFFF ? value.size() : 0xFFFF;
+        WriteU16(static_cast<uint16_t>(length));
+        buffer.append(value.data(), length);
+    }
+
+    // Appends raw bytes
+    void WriteBytes(const void* data, size_t size) { buffer.append(static_cast<const char*>(data), size); }
+
+    // Starts a length-prefixed section and returns its handle for EndSection
+    size_t BeginSection() {
+        size_t offset = buffer.size();
+        WriteU32(0);
+        return offset;
+    }
+
+    // Patches the length prefix of a section with the number of bytes written since BeginSection
+    void EndSection(size_t section) {
+        PatchU32(section, static_cast<uint32_t>(buffer.size() - section - 4));
+    }
+
+    // Overwrites a previously written 32-bit value
+    void PatchU32(size_t offset, uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            buffer[offset + i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+        }
+    }
+
+    // Returns the current size of the buffer
+    size_t Size() const { return buffer.size(); }
+
+private:
+    std::string& buffer;
+
+    void WriteLE(uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; ++i) {
+            buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+    }
+};
+
+// Reads little-endian values from a byte range
+// Reading past the end returns zero and marks the reader as failed, so callers can check once at the end
+class ByteReader {
+public:
+    ByteReader() = default;
+    ByteReader(const char* data, size_t size) : data(reinterpret_cast<const uint8_t*>(data)), size(size) {}
+    explicit ByteReader(const std::string& buffer) : ByteReader(buffer.data(), buffer.size()) {}
+
+    uint8_t ReadU8() { return static_cast<uint8_t>(ReadLE(1)); }
+    uint16_t ReadU16() { return static_cast<uint16_t>(ReadLE(2)); }
+    uint32_t ReadU32() { return static_cast<uint32_t>(ReadLE(4)); }
+    uint64_t ReadU64() { return ReadLE(8); }
+    int32_t ReadI32() { return static_cast<int32_t>(ReadU32()); }
+    bool ReadBool() { return ReadU8() != 0; }
+
+    float ReadF32() {
+        uint32_t bits = ReadU32();
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    std::string ReadString() {
+        uint16_t length = ReadU16();
+        if (!Require(length)) {
+            return std::string();
+        }
+        std::string value(reinterpret_cast<const char*>(data + offset), length);
+        offset += length;
+        return value;
+    }
+
+    // Reads a length-prefixed section into its own reader and skips past it
+    // Anything the section reader leaves unread (fields added by newer versions) is ignored
+    ByteReader ReadSection() {
+        uint32_t length = ReadU32();
+        if (!Require(length)) {
+            ByteReader empty;
+            empty.failed = true;
+            return empty;
+        }
+        ByteReader section(reinterpret_cast<const char*>(data + offset), length);
+        offset += length;
+        return section;
+    }
+
+    // Skips a number of bytes
+    void Skip(size_t bytes) {
+        if (Require(bytes)) {
+            offset += bytes;
+        }
+    }
+
+    // Returns the unread part of the range
+    const char* Current() const { return reinterpret_cast<const char*>(data + offset); }
+    size_t Remaining() const { return size - offset; }
+    bool AtEnd() const { return offset >= size; }
+    bool Failed() const { return failed; }
+
+private:
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    size_t offset = 0;
+    bool failed = false;
+
+    bool Require(size_t bytes) {
+        if (failed || size - offset < bytes) {
+            failed = true;
+            return false;
+        }
+        return true;
+    }
+
+    uint64_t ReadLE(int bytes) {
+        if (!Require(static_cast<size_t>(bytes))) {
+            return 0;
+        }
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; ++i) {
+            value |= static_cast<uint64_t>(data[offset + i]) << (8 * i);
+        }
+        offset += bytes;
+        return value;
+    }
+};
+
+}
+
+#endif
@@ -1,17 +1,38 @@
 #include "Client.h"
 #include <zmq/zmq.hpp>
+#include <fstream>
 #include <iostream>
+#include <algorithm>
 #include <sstream>
 #include <chrono>
+#include <thread>
 
 namespace RiverCore {
 
-// Global ZMQ context and socket
+// Global ZMQ context shared by every client
 static zmq::context_t context(1);
-static zmq::socket_t* clientSocket = nullptr;
+
+namespace {
+
+// Whether a packet carries messages the simulated network must not lose (anything but state and its acks)
+bool IsReliablePacket(const std::string& packet) {
+    size_t offset = 0;
+    MessageType msgType;
+    std::string payload;
+    WireFormat format;
+    while (ReadMessage(packet, offset, msgType, payload, format)) {
+        if (msgType != MessageType::GAME_STATE && msgType != MessageType::GAME_STATE_DELTA &&
+            msgType != MessageType::INPUT_ACK) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}
 
 Client::Client() {
-    lastUpdate = std::chrono::steady_clock::now();
+    lastSend = std::chrono::steady_clock::now();
 }
 
 Client::~Client() {
@@ -28,6 +49,8 @@ bool Client::Connect(const std::string& serverAddress) {
 
     try {
         InitializeSockets(serverAddress);
+        bytesSent = 0;
+        bytesReceived = 0;
 
         // Send connection request
         std::string connectMsg = CreateMessage(MessageType::CONNECT, "");
@@ -39,39 +62,41 @@ bool Client::Connect(const std::string& serverAddress) {
             CleanupSockets();
             return false;
         }
+        bytesSent += connectMsg.size();
 
         // Wait for response
         zmq::message_t reply;
         auto result = clientSocket->recv(reply, zmq::recv_flags::none);
 
         if (result) {
+            bytesReceived += reply.size();
             std::string response(static_cast<char*>(reply.data()), reply.size());
-            std::cout << "Server response: " << response << "\n";
 
-            std::istringstream iss(response);
-            std::string status;
-            uint32_t assignedId;
+            MessageType msgType;
+            std::string payload;
+            uint32_t assignedId = 0;
+            bool accepted = false;
+            if (ParseMessage(response, msgType, payload) && msgType == MessageType::CONNECTED) {
+                assignedId = DeserializeID(payload);
+                accepted = true;
+            } else {
+                // Servers still on the text protocol answer "CONNECTED <id>"
+                std::istringstream iss(response);
+                std::string status;
+                accepted = (iss >> status >> assignedId) && status == "CONNECTED";
+            }
 
-            if (iss >> status >> assignedId && status == "CONNECTED") {
+            if (accepted) {
                 clientId = assignedId;
                 connected = true;
 
                 std::cout << "Connected successfully! Client ID: " << assignedId << "\n";
 
-                // Close connection socket and reconnect to dedicated port
-                CleanupSockets();
-                std::string dedicatedAddress = serverAddress + ":" + std::to_string(5556 + assignedId);
-
-                clientSocket = new zmq::socket_t(context, zmq::socket_type::req);
-                clientSocket->connect("tcp://" + dedicatedAddress);
-
-                int timeout = 1000;
-                clientSocket->set(zmq::sockopt::rcvtimeo, timeout);
-                clientSocket->set(zmq::sockopt::sndtimeo, timeout);
-
+                // The same socket carries everything from here on: input streams up and the server pushes
+                // state every tick
                 return true;
             } else {
-                std::cout << "Invalid response format: " << response << "\n";
+                std::cout << "Invalid response format (" << response.size() << " bytes)\n";
             }
         } else {
             std::cout << "No response from server\n";
@@ -104,7 +129,8 @@ void Client::Disconnect() {
             zmq::message_t request(disconnectMsg.size());
             memcpy(request.data(), disconnectMsg.data(), disconnectMsg.size());
 
-            clientSocket->send(request, zmq::send_flags::none);
+            // Don't block on a server that is already gone
+            clientSocket->send(request, zmq::send_flags::dontwait);
         } catch (const std::exception& e) {
             std::cout << "Error sending disconnect: " << e.what() << "\n";
         }
@@ -114,7 +140,33 @@ void Client::Disconnect() {
     clientId = 0;
     disconnecting = false;
 
-    CleanupSockets();
+    {
+        std::lock_guard<std::mutex> lock(socketMutex);
+        receivedSnapshots.Clear();
+        assetPaths.clear();
+        upstream.Clear();
+        downstream.Clear();
+        latestSnapshotID = 0;
+        sentAckID = 0;
+        pendingInputAck = InputAck();
+        CleanupSockets();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        newSnapshots.clear();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(inputMutex);
+        pendingCommands.clear();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(pendingMessagesMutex);
+        pendingAssets.clear();
+    }
+
     std::cout << "Disconnected from server\n";
 }
 
@@ -123,34 +175,114 @@ void Client::Update() {
         return;
     }
 
-    auto now = std::chrono::steady_clock::now();
-    auto timeSinceLastUpdate = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastUpdate);
+    std::lock_guard<std::mutex> lock(socketMutex);
+    if (!clientSocket) {
+        return;
+    }
+
+    try {
+        // Handle pushed state first, so the input carries the freshest ack
+        ReceiveMessages();
+        SendPendingInput();
+        SendConditionedPackets();
+    } catch (const zmq::error_t& e) {
+        if (e.num() != ETERM) {
+            std::cout << "ZMQ error in update: " << e.what() << "\n";
+        }
+    } catch (const std::exception& e) {
+        std::cout << "Error in update: " << e.what() << "\n";
+    }
+}
 
-    if (timeSinceLastUpdate.count() >= UPDATE_INTERVAL_MS) {
-        SendInputAndReceiveState();
-        lastUpdate = now;
+bool Client::WaitForMessages(int timeoutMs) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(std::max(timeoutMs, 0));
+
+    while (true) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        long sliceMs = std::max<long>(0, std::min<long>(remaining, INPUT_POLL_MS));
+
+        {
+            std::unique_lock<std::mutex> lock(socketMutex);
+            if (!clientSocket || !connected.load() || disconnecting.load()) {
+                // Nothing to wait on, but keep callers from spinning
+                lock.unlock();
+                std::this_thread::sleep_for(std::chrono::milliseconds(std::max<long>(remaining, 0)));
+                return false;
+            }
+
+            try {
+                // Wait in short slices, so input queued meanwhile is not held back until the next snapshot
+                SendPendingInput();
+                SendConditionedPackets();
+
+                // Packets held by the simulated network count as waiting once they are due
+                if (downstream.HasDue(std::chrono::steady_clock::now())) {
+                    return true;
+                }
+
+                zmq::pollitem_t item = { clientSocket->handle(), 0, ZMQ_POLLIN, 0 };
+                zmq::poll(&item, 1, std::chrono::milliseconds(sliceMs));
+                if (item.revents & ZMQ_POLLIN) {
+                    return true;
+                }
+            } catch (const zmq::error_t& e) {
+                if (e.num() != ETERM) {
+                    std::cout << "ZMQ error while waiting for messages: " << e.what() << "\n";
+                }
+                return false;
+            }
+        }
+
+        if (remaining <= 0) {
+            return false;
+        }
     }
 }
 
-void Client::SendInput(const std::unordered_map<std::string, bool>& buttons,
-                       const std::unordered_map<std::string, float>& axes) {
+void Client::SendInput(const InputState& input) {
     if (!connected.load()) {
         return;
     }
 
     std::lock_guard<std::mutex> lock(inputMutex);
+    inputChanged = true;
     pendingInput.clientID = clientId.load();
-    pendingInput.buttons = buttons;
-    pendingInput.axes = axes;
+    pendingInput.buttons = input.buttons;
+    pendingInput.axes = input.axes;
+    pendingInput.sequence = 0;
     pendingInput.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
         std::chrono::steady_clock::now().time_since_epoch()).count();
 }
 
+void Client::QueueInputCommand(const InputState& command) {
+    if (!connected.load()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(inputMutex);
+    pendingCommands.push_back(command);
+    pendingCommands.back().clientID = clientId.load();
+    if (pendingCommands.size() > MAX_PENDING_COMMANDS) {
+        pendingCommands.erase(pendingCommands.begin());
+    }
+
+    // Keepalives repeat the last command, which the server ignores as already seen
+    pendingInput = pendingCommands.back();
+}
+
 GameStateSnapshot Client::GetLatestGameState() {
     std::lock_guard<std::mutex> lock(stateMutex);
     return latestState;
 }
 
+std::vector<ReceivedSnapshot> Client::GetReceivedSnapshots() {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    std::vector<ReceivedSnapshot> snapshots = std::move(newSnapshots);
+    newSnapshots.clear();
+    return snapshots;
+}
+
 std::vector<EntitySpawnInfo> Client::GetPendingSpawns() {
     std::lock_guard<std::mutex> lock(pendingMessagesMutex);
     std::vector<EntitySpawnInfo> spawns = std::move(pendingSpawns);
@@ -165,10 +297,52 @@ std::vector<uint32_t> Client::GetPendingDespawns() {
     return despawns;
 }
 
+std::vector<std::string> Client::GetPendingAssets() {
+    std::lock_guard<std::mutex> lock(pendingMessagesMutex);
+    std::vector<std::string> assets = std::move(pendingAssets);
+    pendingAssets.clear();
+    return assets;
+}
+
+bool Client::ResolveSprite(EntitySpawnInfo& spawnInfo) const {
+    // Text spawns carry the path itself
+    if (!spawnInfo.spritePath.empty()) {
+        return true;
+    }
+    if (spawnInfo.spriteID == 0 || spawnInfo.spriteID > assetPaths.size()) {
+        std::cout << "Spawn of entity " << spawnInfo.entityID << " references unknown asset " << spawnInfo.spriteID << "\n";
+        return false;
+    }
+    spawnInfo.spritePath = assetPaths[spawnInfo.spriteID - 1];
+    return true;
+}
+
+void Client::StoreSnapshot(std::shared_ptr<const GameStateSnapshot> snapshot) {
+    // Update latest state
+    {
+        std::lock_guard<std::mutex> stateLock(stateMutex);
+        latestState = *snapshot;
+
+        // Queue it for interpolation, keeping only the most recent ones if nobody collects them
+        uint32_t inputAck = pendingInputAck.snapshotID == snapshot->snapshotID ? pendingInputAck.sequence : 0;
+        newSnapshots.push_back({snapshot, std::chrono::steady_clock::now(), inputAck});
+        if (newSnapshots.size() > SNAPSHOT_HISTORY_SIZE) {
+            newSnapshots.erase(newSnapshots.begin());
+        }
+    }
+
+    if (snapshot->snapshotID != 0) {
+        latestSnapshotID = snapshot->snapshotID;
+        receivedSnapshots.Store(std::move(snapshot));
+    }
+}
+
 void Client::InitializeSockets(const std::string& serverAddress) {
     try {
-        clientSocket = new zmq::socket_t(context, zmq::socket_type::req);
-        std::string address = "tcp://" + serverAddress + ":5555";
+        // Asynchronous socket, so the server can push state without waiting for a request
+        clientSocket = new zmq::socket_t(context, zmq::socket_type::dealer);
+        clientSocket->set(zmq::sockopt::linger, 200);
+        std::string address = "tcp://" + serverAddress + ":" + std::to_string(SERVER_PORT);
         clientSocket->connect(address);
 
         int timeout = 5000;
@@ -193,81 +367,219 @@ void Client::CleanupSockets() {
     }
 }
 
-void Client::SendInputAndReceiveState() {
-    if (!clientSocket || !connected.load() || disconnecting.load()) {
+void Client::SendPendingInput() {
+    if (!clientSocket) {
         return;
     }
 
-    std::lock_guard<std::mutex> lock(socketMutex);
+    auto now = std::chrono::steady_clock::now();
 
-    try {
-        // Get pending input
-        InputState inputToSend;
-        {
+    InputState inputToSend;
+    std::vector<InputState>& commands = sendingCommands;
+    bool sendInput;
+    {
+        std::lock_guard<std::mutex> inputLock(inputMutex);
+        commands.clear();
+        commands.swap(pendingCommands);
+        sendInput = inputChanged || !commands.empty();
+        inputToSend = pendingInput;
+    }
+    bool sendAck = latestSnapshotID != sentAckID;
+    bool keepalive = now - lastSend >= std::chrono::milliseconds(KEEPALIVE_INTERVAL_MS);
+    if (!sendInput && !sendAck && !keepalive) {
+        return;
+    }
+
+    // Stream the input (repeated as a keepalive), acknowledging the latest snapshot so the next push can be
+    // a delta against it
+    std::string packet;
+    for (const InputState& command : commands) {
+        AppendMessage(packet, MessageType::INPUT, command.Serialize());
+    }
+    if (commands.empty() && (sendInput || keepalive)) {
+        AppendMessage(packet, MessageType::INPUT, inputToSend.Serialize());
+    }
+    if (latestSnapshotID != 0) {
+        AppendMessage(packet, MessageType::SNAPSHOT_ACK, SerializeID(latestSnapshotID));
+    }
+
+    // Through the simulated network the packet counts as sent once it enters the link
+    bool sent = false;
+    if (upstream.IsEnabled()) {
+        bytesSent += packet.size();
+        upstream.Push(std::move(packet), false, now);
+        sent = true;
+    } else {
+        zmq::message_t message(packet.size());
+        memcpy(message.data(), packet.data(), packet.size());
+        if (clientSocket->send(message, zmq::send_flags::dontwait)) {
+            bytesSent += packet.size();
+            sent = true;
+        }
+    }
+
+    if (sent) {
+        sentAckID = latestSnapshotID;
+        lastSend = now;
+        if (sendInput) {
             std::lock_guard<std::mutex> inputLock(inputMutex);
-            inputToSend = pendingInput;
+            inputChanged = false;
         }
+    } else if (!commands.empty()) {
+        // Put the commands back in front of any queued meanwhile, to be sent with the next attempt
+        std::lock_guard<std::mutex> inputLock(inputMutex);
+        commands.insert(commands.end(), pendingCommands.begin(), pendingCommands.end());
+        pendingCommands.swap(commands);
+        if (pendingCommands.size() > MAX_PENDING_COMMANDS) {
+            pendingCommands.erase(pendingCommands.begin(), pendingCommands.end() - MAX_PENDING_COMMANDS);
+        }
+    }
+}
+
+void Client::SendConditionedPackets() {
+    if (!clientSocket || !upstream.IsEnabled()) {
+        return;
+    }
 
-        // Send input to server
-        std::string inputMsg = CreateMessage(MessageType::INPUT, inputToSend.Serialize());
-        zmq::message_t request(inputMsg.size());
-        memcpy(request.data(), inputMsg.data(), inputMsg.size());
-
-        if (clientSocket->send(request, zmq::send_flags::none)) {
-            // Receive game state response
-            zmq::message_t reply;
-            auto result = clientSocket->recv(reply, zmq::recv_flags::none);
-
-            if (result) {
-                std::string response(static_cast<char*>(reply.data()), reply.size());
-
-                // Server sends multiple messages separated by newlines
-                std::istringstream responseStream(response);
-                std::string line;
-
-                while (std::getline(responseStream, line)) {
-                    if (line.empty()) continue;
-
-                    MessageType msgType;
-                    std::string payload;
-                    if (ParseMessage(line, msgType, payload)) {
-                        if (msgType == MessageType::SPAWN_ENTITY) {
-                            // Parse and queue entity spawn
-                            EntitySpawnInfo spawnInfo = EntitySpawnInfo::Deserialize(payload);
-                            {
-                                std::lock_guard<std::mutex> msgLock(pendingMessagesMutex);
-                                pendingSpawns.push_back(spawnInfo);
-                            }
-                        }
-                        else if (msgType == MessageType::DESPAWN_ENTITY) {
-                            // Parse and queue entity despawn
-                            uint32_t entityID = std::stoul(payload);
-                            {
-                                std::lock_guard<std::mutex> msgLock(pendingMessagesMutex);
-                                pendingDespawns.push_back(entityID);
-                            }
-                        }
-                        else if (msgType == MessageType::GAME_STATE) {
-                            // Parse game state
-                            GameStateSnapshot newState = GameStateSnapshot::Deserialize(payload);
-
-                            // Update latest state
-                            {
-                                std::lock_guard<std::mutex> stateLock(stateMutex);
-                                latestState = newState;
-                            }
-                        }
+    // A packet the socket cannot take is lost like any other
+    std::string packet;
+    while (upstream.Pop(std::chrono::steady_clock::now(), packet)) {
+        zmq::message_t message(packet.size());
+        memcpy(message.data(), packet.data(), packet.size());
+        clientSocket->send(message, zmq::send_flags::dontwait);
+    }
+}
+
+void Client::ReceiveMessages() {
+    if (!clientSocket) {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    zmq::message_t message;
+    while (clientSocket->recv(message, zmq::recv_flags::dontwait)) {
+        bytesReceived += message.size();
+        std::string packet(static_cast<char*>(message.data()), message.size());
+        if (downstream.IsEnabled()) {
+            bool reliable = IsReliablePacket(packet);
+            downstream.Push(std::move(packet), reliable, now);
+        } else {
+            HandleMessages(packet);
+        }
+    }
+
+    // Handle what the simulated network has delivered by now
+    std::string delivered;
+    while (downstream.Pop(now, delivered)) {
+        HandleMessages(delivered);
+    }
+}
+
+void Client::SetNetworkConditions(const NetworkConditions& conditions) {
+    std::lock_guard<std::mutex> lock(socketMutex);
+
+    upstream.SetLog(nullptr, nullptr);
+    downstream.SetLog(nullptr, nullptr);
+    conditionsLog.reset();
+    if (conditions.IsEnabled() && !conditions.logPath.empty()) {
+        auto file = std::make_unique<std::ofstream>(conditions.logPath);
+        if (*file) {
+            conditionsLog = std::move(file);
+            upstream.SetLog(conditionsLog.get(), &conditionsLogMutex);
+            downstream.SetLog(conditionsLog.get(), &conditionsLogMutex);
+        } else {
+            std::cout << "Cannot open network conditions log " << conditions.logPath << "\n";
+        }
+    }
+
+    // Each direction draws from its own sequence
+    upstream.SetConditions(conditions, 0);
+    downstream.SetConditions(conditions, 1);
+
+    if (conditions.IsEnabled()) {
+        std::cout << "Simulating network conditions: " << conditions.ToString() << "\n";
+    }
+}
+
+void Client::HandleMessages(const std::string& packet) {
+    // Server sends several messages in one packet
+    size_t offset = 0;
+    MessageType msgType;
+    std::string payload;
+    WireFormat format;
+
+    while (ReadMessage(packet, offset, msgType, payload, format)) {
+        if (msgType == MessageType::SPAWN_ENTITY) {
+            // Parse and queue entity spawn
+            EntitySpawnInfo spawnInfo = EntitySpawnInfo::Deserialize(payload, format);
+            if (ResolveSprite(spawnInfo)) {
+                std::lock_guard<std::mutex> msgLock(pendingMessagesMutex);
+                pendingSpawns.push_back(spawnInfo);
+            }
+        }
+        else if (msgType == MessageType::WORLD_CHUNK) {
+            // Queue a batch of the world streamed on connect
+            std::vector<EntitySpawnInfo> spawns;
+            if (DeserializeSpawnChunk(payload, snapshotQuantization, spawns)) {
+                std::lock_guard<std::mutex> msgLock(pendingMessagesMutex);
+                for (EntitySpawnInfo& spawnInfo : spawns) {
+                    if (ResolveSprite(spawnInfo)) {
+                        pendingSpawns.push_back(std::move(spawnInfo));
                     }
                 }
+            } else {
+                std::cout << "Dropped malformed world chunk\n";
             }
         }
-
-    } catch (const zmq::error_t& e) {
-        if (e.num() != ETERM) {
-            std::cout << "ZMQ error in send/receive: " << e.what() << "\n";
+        else if (msgType == MessageType::ASSET_TABLE) {
+            // Entries arrive in ID order; ones already known are skipped
+            AssetTableUpdate update = AssetTableUpdate::Deserialize(payload);
+            std::lock_guard<std::mutex> msgLock(pendingMessagesMutex);
+            for (size_t i = 0; i < update.paths.size(); ++i) {
+                if (update.firstID + i == assetPaths.size() + 1) {
+                    assetPaths.push_back(update.paths[i]);
+                    pendingAssets.push_back(update.paths[i]);
+                }
+            }
+        }
+        else if (msgType == MessageType::DESPAWN_ENTITY) {
+            // Parse and queue entity despawn
+            uint32_t entityID = DeserializeID(payload, format);
+            {
+                std::lock_guard<std::mutex> msgLock(pendingMessagesMutex);
+                // An entity whose spawn was not picked up yet is simply never spawned
+                auto spawn = std::find_if(pendingSpawns.begin(), pendingSpawns.end(),
+                    [entityID](const EntitySpawnInfo& info) { return info.entityID == entityID; });
+                if (spawn != pendingSpawns.end()) {
+                    pendingSpawns.erase(spawn);
+                } else {
+                    pendingDespawns.push_back(entityID);
+                }
+            }
+        }
+        else if (msgType == MessageType::GAME_STATE) {
+            // Parse game state
+            StoreSnapshot(std::make_shared<GameStateSnapshot>(GameStateSnapshot::Deserialize(payload, format)));
+        }
+        else if (msgType == MessageType::INPUT_ACK) {
+            pendingInputAck = InputAck::Deserialize(payload, format);
+        }
+        else if (msgType == MessageType::SNAPSHOT_CONFIG) {
+            snapshotQuantization = SnapshotQuantization::Deserialize(payload);
+        }
+        else if (msgType == MessageType::GAME_STATE_DELTA) {
+            // Rebuild the game state from the baseline it was encoded against (none for keyframes)
+            static const GameStateSnapshot emptyBaseline;
+            uint32_t baselineID = GetSnapshotDeltaBaseline(payload);
+            std::shared_ptr<const GameStateSnapshot> baseline = receivedSnapshots.Find(baselineID);
+            auto newState = std::make_shared<GameStateSnapshot>();
+            if ((baseline || baselineID == 0) &&
+                DeserializeSnapshotDelta(baseline ? *baseline : emptyBaseline, payload, snapshotQuantization, *newState)) {
+                StoreSnapshot(std::move(newState));
+            } else {
+                std::cout << "Dropped game state delta with unknown baseline\n";
+            }
         }
-    } catch (const std::exception& e) {
-        std::cout << "Error in send/receive: " << e.what() << "\n";
     }
 }
 
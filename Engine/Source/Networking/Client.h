@@ -2,14 +2,29 @@
 #define CLIENT_H
 
 #include "NetworkProtocol.h"
+#include "SnapshotDelta.h"
+#include "NetworkConditioner.h"
 #include <string>
 #include <unordered_map>
 #include <chrono>
 #include <mutex>
 #include <atomic>
+#include <memory>
+#include <vector>
+
+namespace zmq {
+class socket_t;
+}
 
 namespace RiverCore {
 
+// Game state as received from the server, with its local arrival time
+struct ReceivedSnapshot {
+    std::shared_ptr<const GameStateSnapshot> snapshot;
+    std::chrono::steady_clock::time_point receivedAt;
+    uint32_t inputAck = 0;  // Last input command the server applied before capturing it (0 = unknown)
+};
+
 class Client {
 public:
     Client();
@@ -19,54 +34,120 @@ public:
     bool Connect(const std::string& serverAddress);
     // Disconnect from server gracefully
     void Disconnect();
-    // Update client networking
+    // Update client networking: streams pending input to the server and handles everything it pushed
     void Update();
+    // Block until the server pushes a message or the timeout expires (input queued meanwhile is still sent)
+    // Returns true if a message is waiting
+    bool WaitForMessages(int timeoutMs);
 
     // Send input to server (thread-safe)
-    void SendInput(const std::unordered_map<std::string, bool>& buttons,
-                   const std::unordered_map<std::string, float>& axes = {});
+    void SendInput(const InputState& input);
+    // Queue a sequenced input command (thread-safe)
+    // Every queued command is sent once, in order, and the server applies one per tick
+    void QueueInputCommand(const InputState& command);
 
     // Get latest game state from server (thread-safe)
     GameStateSnapshot GetLatestGameState();
+    // Get and clear the game states received since the last call, oldest first (thread-safe)
+    std::vector<ReceivedSnapshot> GetReceivedSnapshots();
 
     // Get and clear pending entity spawn messages (thread-safe)
     std::vector<EntitySpawnInfo> GetPendingSpawns();
     // Get and clear pending entity despawn messages (thread-safe)
     std::vector<uint32_t> GetPendingDespawns();
+    // Get and clear the asset paths the server registered since the last call, e.g. to load their textures
+    // ahead of the spawns using them (thread-safe)
+    std::vector<std::string> GetPendingAssets();
 
     // Check if connected to server
     bool IsConnected() const { return connected.load() && clientId.load() != 0; }
     // Get this client's ID
     uint32_t GetClientId() const { return clientId.load(); }
 
+    // Simulate network conditions on both directions of the connection, e.g. to tune interpolation on loopback
+    // (thread-safe; default conditions turn the simulation off). The handshake is never affected.
+    void SetNetworkConditions(const NetworkConditions& conditions);
+
+    // Get the bytes sent to the server since connecting, including the handshake
+    uint64_t GetBytesSent() const { return bytesSent.load(); }
+    // Get the bytes received from the server since connecting, including the handshake
+    uint64_t GetBytesReceived() const { return bytesReceived.load(); }
+
 private:
     // Thread-safe connection state
     std::atomic<bool> connected{false};
     std::atomic<uint32_t> clientId{0};
     std::atomic<bool> disconnecting{false};
 
-    // Latest input to send
+    // Latest input to send (repeated as a keepalive), and the input commands not sent yet
     InputState pendingInput;
+    bool inputChanged = false;
+    std::vector<InputState> pendingCommands;
     mutable std::mutex inputMutex;
+    // Commands being sent, swapped with pendingCommands so both keep their capacity (guarded by socketMutex)
+    std::vector<InputState> sendingCommands;
+    // Unsent commands kept while the socket cannot send; older ones are dropped
+    static constexpr size_t MAX_PENDING_COMMANDS = 64;
 
-    // Latest game state received
+    // Latest game state received, and every state received since the last GetReceivedSnapshots call
     GameStateSnapshot latestState;
+    std::vector<ReceivedSnapshot> newSnapshots;
     mutable std::mutex stateMutex;
 
-    // Pending entity spawn/despawn messages
+    // Recently received snapshots, kept as baselines for delta-encoded states (guarded by socketMutex)
+    SnapshotHistory receivedSnapshots;
+    uint32_t latestSnapshotID = 0;
+    uint32_t sentAckID = 0;
+    SnapshotQuantization snapshotQuantization;
+    // Input ack received for the snapshot that follows it
+    InputAck pendingInputAck;
+
+    // Asset paths by ID - 1, as received from the server's asset table (guarded by socketMutex)
+    std::vector<std::string> assetPaths;
+
+    // Pending entity spawn/despawn messages and newly received asset paths
     std::vector<EntitySpawnInfo> pendingSpawns;
     std::vector<uint32_t> pendingDespawns;
+    std::vector<std::string> pendingAssets;
     mutable std::mutex pendingMessagesMutex;
 
+    // Socket connected to the server (one per client, so a process can run several)
+    zmq::socket_t* clientSocket = nullptr;
     // Mutex for socket synchronization
     mutable std::mutex socketMutex;
 
-    // Connection timing
-    std::chrono::time_point<std::chrono::steady_clock> lastUpdate;
-    static constexpr int UPDATE_INTERVAL_MS = 16;
-
-    // Send input and receive game state
-    void SendInputAndReceiveState();
+    // Traffic since connecting
+    std::atomic<uint64_t> bytesSent{0};
+    std::atomic<uint64_t> bytesReceived{0};
+
+    // Simulated network between the socket and the client (guarded by socketMutex)
+    NetworkConditioner upstream{"up"};
+    NetworkConditioner downstream{"down"};
+    std::unique_ptr<std::ostream> conditionsLog;
+    std::mutex conditionsLogMutex;
+
+    // Port of the server socket
+    static constexpr int SERVER_PORT = 5555;
+
+    // Connection timing (guarded by socketMutex)
+    std::chrono::time_point<std::chrono::steady_clock> lastSend;
+    // Longest time without sending anything, so the server keeps seeing the client's acks
+    static constexpr int KEEPALIVE_INTERVAL_MS = 250;
+    // Longest time queued input waits while blocked in WaitForMessages
+    static constexpr int INPUT_POLL_MS = 4;
+
+    // Send queued input and the latest snapshot ack, if either changed (call with socketMutex held)
+    void SendPendingInput();
+    // Send the packets the simulated network has delivered upstream (call with socketMutex held)
+    void SendConditionedPackets();
+    // Handle every message the server has pushed so far (call with socketMutex held)
+    void ReceiveMessages();
+    // Handle the messages of one received packet
+    void HandleMessages(const std::string& packet);
+    // Store a received snapshot as the latest state and as a future delta baseline
+    void StoreSnapshot(std::shared_ptr<const GameStateSnapshot> snapshot);
+    // Fill in a binary spawn's sprite path from its asset ID; returns false if the ID is unknown
+    bool ResolveSprite(EntitySpawnInfo& spawnInfo) const;
 
     // Socket management
     void InitializeSockets(const std::string& serverAddress);
@@ -0,0 +1,84 @@
+#include "InputActions.h"
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <mutex>
+
+namespace RiverCore {
+
+namespace {
+
+// Names of the registered actions, indexed by ID
+template <size_t Capacity>
+struct ActionNames {
+    std::array<std::string, Capacity> names;
+    size_t count = 0;
+
+    InputActionID Find(const std::string& name) const {
+        auto end = names.begin() + count;
+        auto it = std::find(names.begin(), end, name);
+        return it != end ? static_cast<InputActionID>(it - names.begin()) : INVALID_INPUT_ACTION;
+    }
+
+    InputActionID Register(const std::string& name, const char* kind) {
+        InputActionID id = Find(name);
+        if (id != INVALID_INPUT_ACTION) {
+            return id;
+        }
+        if (count == Capacity) {
+            std::cout << "Cannot register " << kind << " action " << name << ", all " << Capacity
+                      << " are in use\n";
+            return INVALID_INPUT_ACTION;
+        }
+        names[count] = name;
+        return static_cast<InputActionID>(count++);
+    }
+
+    std::string GetName(InputActionID id) const {
+        return id < count ? names[id] : std::string();
+    }
+};
+
+std::mutex registryMutex;
+ActionNames<MAX_BUTTON_ACTIONS> buttonNames;
+ActionNames<MAX_AXIS_ACTIONS> axisNames;
+
+}
+
+InputActionID InputActions::RegisterButton(const std::string& name) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    return buttonNames.Register(name, "button");
+}
+
+InputActionID InputActions::RegisterAxis(const std::string& name) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    return axisNames.Register(name, "axis");
+}
+
+InputActionID InputActions::FindButton(const std::string& name) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    return buttonNames.Find(name);
+}
+
+InputActionID InputActions::FindAxis(const std::string& name) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    return axisNames.Find(name);
+}
+
+std::string InputActions::GetButtonName(InputActionID button) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    return buttonNames.GetName(button);
+}
+
+std::string InputActions::GetAxisName(InputActionID axis) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    return axisNames.GetName(axis);
+}
+
+void InputActions::Clear() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    buttonNames = {};
+    axisNames = {};
+}
+
+}
@@ -0,0 +1,48 @@
+#ifndef INPUTACTIONS_H
+#define INPUTACTIONS_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace RiverCore {
+
+// ID of a registered input action, indexing InputState's button bits or axis values
+using InputActionID = uint8_t;
+
+// Number of button and axis actions an InputState can carry
+constexpr size_t MAX_BUTTON_ACTIONS = 64;
+constexpr size_t MAX_AXIS_ACTIONS = 8;
+// ID returned for names that are not registered (or could not be)
+constexpr InputActionID INVALID_INPUT_ACTION = 0xFF;
+
+// Process-wide registry giving each named input action a small ID, so input is carried as a button bitmask and
+// an axis array instead of string-keyed maps
+// IDs are assigned in registration order, so the client and the server must register the same actions in the
+// same order (e.g. from shared game setup code run before connecting or starting the server). The legacy text
+// format still carries names, translated through the registry.
+class InputActions {
+public:
+    // Registers a button action, returning its ID (registering a name again returns its existing ID)
+    // Returns INVALID_INPUT_ACTION once MAX_BUTTON_ACTIONS buttons are registered
+    static InputActionID RegisterButton(const std::string& name);
+    // Registers an axis action, returning its ID (registering a name again returns its existing ID)
+    // Returns INVALID_INPUT_ACTION once MAX_AXIS_ACTIONS axes are registered
+    static InputActionID RegisterAxis(const std::string& name);
+
+    // Finds the ID of a registered button (INVALID_INPUT_ACTION if not registered)
+    static InputActionID FindButton(const std::string& name);
+    // Finds the ID of a registered axis (INVALID_INPUT_ACTION if not registered)
+    static InputActionID FindAxis(const std::string& name);
+    // Gets the name of a registered button (empty if not registered)
+    static std::string GetButtonName(InputActionID button);
+    // Gets the name of a registered axis (empty if not registered)
+    static std::string GetAxisName(InputActionID axis);
+
+    // Forgets every registered action
+    static void Clear();
+};
+
+}
+
+#endif
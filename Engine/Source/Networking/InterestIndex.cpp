@@ -0,0 +1,99 @@
+#include "InterestIndex.h"
+#include <algorithm>
+#include <cmath>
+
+namespace RiverCore {
+
+InterestIndex::InterestIndex(std::shared_ptr<const FrameState> frame, const InterestArea& area)
+    : frame(std::move(frame)), area(area) {
+    const FrameState& state = *this->frame;
+
+    // Size cells so a query over the area walks about 7x7 cells
+    float reach = std::max(area.radius, std::max(area.halfExtents.x, area.halfExtents.y)) + area.hysteresis;
+    grid.SetCellSize(std::max(64.0f, reach / 3.0f));
+    grid.Clear(state.Size());
+
+    bounds.resize(state.Size());
+    indexByID.reserve(state.Size());
+    for (size_t i = 0; i < state.Size(); ++i) {
+        // Same bounds as the collision step: centered on the position, sized by the scaled frame
+        const Vec2& position = state.transform.position[i];
+        Vec2 size(state.frameSize[i].x * std::abs(state.transform.scale[i].x),
+                  state.frameSize[i].y * std::abs(state.transform.scale[i].y));
+        AABB& box = bounds[i];
+        box.minX = position.x - size.x / 2.0f;
+        box.maxX = position.x + size.x / 2.0f;
+        box.minY = position.y - size.y / 2.0f;
+        box.maxY = position.y + size.y / 2.0f;
+
+        grid.Insert(static_cast<uint32_t>(i), box);
+        indexByID[state.ids[i]] = static_cast<uint32_t>(i);
+    }
+}
+
+int64_t InterestIndex::FindIndex(uint32_t entityID) const {
+    auto it = indexByID.find(entityID);
+    return it != indexByID.end() ? static_cast<int64_t>(it->second) : -1;
+}
+
+bool InterestIndex::Touches(const AABB& box, const Vec2& center, float margin) const {
+    if (area.halfExtents.x > 0.0f && area.halfExtents.y > 0.0f) {
+        if (box.maxX < center.x - area.halfExtents.x - margin || box.minX > center.x + area.halfExtents.x + margin ||
+            box.maxY < center.y - area.halfExtents.y - margin || box.minY > center.y + area.halfExtents.y + margin) {
+            return false;
+        }
+    }
+    if (area.radius > 0.0f) {
+        // Distance from the center to the closest point of the box
+        float dx = std::max(box.minX - center.x, std::max(0.0f, center.x - box.maxX));
+        float dy = std::max(box.minY - center.y, std::max(0.0f, center.y - box.maxY));
+        float reach = area.radius + margin;
+        if (dx * dx + dy * dy > reach * reach) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void InterestIndex::Collect(uint32_t viewerEntityID, const std::vector<uint32_t>& previous,
+                            std::vector<uint32_t>& relevant) const {
+    relevant.clear();
+
+    int64_t viewer = FindIndex(viewerEntityID);
+    if (viewer < 0) {
+        return;
+    }
+
+    const AABB& viewerBox = bounds[static_cast<size_t>(viewer)];
+    Vec2 center((viewerBox.minX + viewerBox.maxX) / 2.0f, (viewerBox.minY + viewerBox.maxY) / 2.0f);
+
+    // Query the outer box (area plus hysteresis), then apply the exact shape per candidate
+    float reachX = area.halfExtents.x > 0.0f ? area.halfExtents.x : area.radius;
+    float reachY = area.halfExtents.y > 0.0f ? area.halfExtents.y : area.radius;
+    if (area.radius > 0.0f) {
+        reachX = std::min(reachX, area.radius);
+        reachY = std::min(reachY, area.radius);
+    }
+    AABB query;
+    query.minX = center.x - reachX - area.hysteresis;
+    query.maxX = center.x + reachX + area.hysteresis;
+    query.minY = center.y - reachY - area.hysteresis;
+    query.maxY = center.y + reachY + area.hysteresis;
+
+    std::vector<uint32_t> candidates;
+    grid.Query(query, candidates);
+
+    const FrameState& state = *frame;
+    for (uint32_t index : candidates) {
+        uint32_t entityID = state.ids[index];
+        const AABB& box = bounds[index];
+        if (index == static_cast<uint32_t>(viewer) || Touches(box, center, 0.0f) ||
+            (Touches(box, center, area.hysteresis) && std::binary_search(previous.begin(), previous.end(), entityID))) {
+            relevant.push_back(entityID);
+        }
+    }
+
+    std::sort(relevant.begin(), relevant.end());
+}
+
+}
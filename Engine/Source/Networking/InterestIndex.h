@@ -0,0 +1,56 @@
+#ifndef INTERESTINDEX_H
+#define INTERESTINDEX_H
+
+#include "Renderer/FrameState.h"
+#include "Physics/SpatialHashGrid.h"
+#include "Math/Math.h"
+#include <unordered_map>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+namespace RiverCore {
+
+// Area around a client's player entity in which entities are replicated to that client
+// With both shapes set an entity must touch both; with neither set filtering is disabled
+struct InterestArea {
+    float radius = 0.0f;                    // Circle around the player entity (0 = not used)
+    Vec2 halfExtents = Vec2::zero();        // Rectangle around the player entity, e.g. half the camera view (zero = not used)
+    float hysteresis = 64.0f;               // Distance a relevant entity may move past the area before it is dropped
+
+    // Returns whether entities are filtered at all
+    bool IsEnabled() const { return radius > 0.0f || (halfExtents.x > 0.0f && halfExtents.y > 0.0f); }
+};
+
+// Spatial index over one published frame, answering which entities lie in a client's area of interest
+// Built once per tick by the simulation thread, then shared read-only by the network thread and its encoding
+// workers, so the per-client cost depends on how many entities are nearby rather than on the size of the world
+class InterestIndex {
+public:
+    InterestIndex(std::shared_ptr<const FrameState> frame, const InterestArea& area);
+
+    // Returns the frame the index was built from
+    const FrameState& GetFrame() const { return *frame; }
+    // Returns the dense frame index of an entity, or -1 if it is not in the frame
+    int64_t FindIndex(uint32_t entityID) const;
+
+    // Collects the IDs of the entities relevant to a viewer entity, sorted ascending
+    // The viewer itself is always relevant; entities in previous (sorted IDs) stay relevant until they leave
+    // the area grown by the hysteresis. A viewer missing from the frame sees nothing.
+    void Collect(uint32_t viewerEntityID, const std::vector<uint32_t>& previous, std::vector<uint32_t>& relevant) const;
+
+private:
+    std::shared_ptr<const FrameState> frame;
+    InterestArea area;
+
+    SpatialHashGrid grid;
+    std::vector<AABB> bounds;
+    std::unordered_map<uint32_t, uint32_t> indexByID;
+
+    // Returns whether a box touches the area around a center grown by a margin
+    bool Touches(const AABB& box, const Vec2& center, float margin) const;
+};
+
+}
+
+#endif
@@ -0,0 +1,154 @@
+#include "NetworkConditioner.h"
+#include <algorithm>
+#include <sstream>
+
+namespace RiverCore {
+
+namespace {
+
+std::chrono::steady_clock::duration Milliseconds(double ms) {
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double, std::milli>(ms));
+}
+
+}
+
+bool NetworkConditions::Parse(const std::string& spec, NetworkConditions& conditions) {
+    std::istringstream entries(spec);
+    std::string entry;
+    while (std::getline(entries, entry, ',')) {
+        if (entry.empty()) {
+            continue;
+        }
+
+        size_t separator = entry.find('=');
+        if (separator == std::string::npos) {
+            return false;
+        }
+        std::string key = entry.substr(0, separator);
+        std::string value = entry.substr(separator + 1);
+
+        try {
+            if (key == "delay") conditions.delayMs = std::stof(value);
+            else if (key == "jitter") conditions.jitterMs = std::stof(value);
+            else if (key == "drop") conditions.dropRate = std::stof(value);
+            else if (key == "reorder") conditions.reorderRate = std::stof(value);
+            else if (key == "reorderdelay") conditions.reorderDelayMs = std::stof(value);
+            else if (key == "bandwidth") conditions.bandwidth = static_cast<uint32_t>(std::stoul(value));
+            else if (key == "seed") conditions.seed = static_cast<uint32_t>(std::stoul(value));
+            else if (key == "log") conditions.logPath = value;
+            else return false;
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string NetworkConditions::ToString() const {
+    std::ostringstream oss;
+    oss << "delay=" << delayMs << ",jitter=" << jitterMs << ",drop=" << dropRate << ",reorder=" << reorderRate
+        << ",reorderdelay=" << reorderDelayMs << ",bandwidth=" << bandwidth << ",seed=" << seed;
+    if (!logPath.empty()) {
+        oss << ",log=" << logPath;
+    }
+    return oss.str();
+}
+
+void NetworkConditioner::SetConditions(const NetworkConditions& newConditions, uint32_t seedOffset) {
+    conditions = newConditions;
+    enabled = conditions.IsEnabled();
+    random.seed(conditions.seed + seedOffset);
+
+    Clear();
+    startTime = Clock::now();
+
+    if (log && enabled) {
+        std::lock_guard<std::mutex> lock(*logMutex);
+        *log << "# " << name << " " << conditions.ToString() << " (seed offset " << seedOffset << ")\n";
+    }
+}
+
+void NetworkConditioner::SetLog(std::ostream* newLog, std::mutex* newLogMutex) {
+    log = newLog;
+    logMutex = newLogMutex;
+}
+
+void NetworkConditioner::Push(std::string packet, bool reliable, Clock::time_point now) {
+    uint64_t packetNumber = ++sentPackets;
+
+    // The same number of draws per packet keeps the sequence of decisions independent of the outcomes
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    float dropRoll = unit(random);
+    float reorderRoll = unit(random);
+    float jitterRoll = unit(random);
+
+    if (!reliable && dropRoll < conditions.dropRate) {
+        Log(now, packetNumber, packet.size(), reliable, "drop", now);
+        return;
+    }
+
+    // Time the link takes to carry the packet, after the ones already queued on it
+    Clock::time_point sentAt = now;
+    if (conditions.bandwidth > 0) {
+        Clock::time_point start = std::max(linkFreeAt, now);
+        if (!reliable && start - now > MAX_BACKLOG) {
+            Log(now, packetNumber, packet.size(), reliable, "overflow", now);
+            return;
+        }
+        linkFreeAt = start + Milliseconds(1000.0 * static_cast<double>(packet.size()) / conditions.bandwidth);
+        sentAt = linkFreeAt;
+    }
+
+    Clock::time_point deliverAt = sentAt + Milliseconds(conditions.delayMs + jitterRoll * conditions.jitterMs);
+    const char* action = "deliver";
+    if (reliable) {
+        deliverAt = std::max(deliverAt, lastReliableAt);
+        lastReliableAt = deliverAt;
+    } else if (reorderRoll < conditions.reorderRate) {
+        deliverAt += Milliseconds(conditions.reorderDelayMs);
+        action = "reorder";
+    }
+
+    Log(now, packetNumber, packet.size(), reliable, action, deliverAt);
+    inFlight.emplace(std::make_pair(deliverAt, packetNumber), std::move(packet));
+}
+
+bool NetworkConditioner::Pop(Clock::time_point now, std::string& packet) {
+    if (!HasDue(now)) {
+        return false;
+    }
+
+    auto next = inFlight.begin();
+    packet = std::move(next->second);
+    inFlight.erase(next);
+    return true;
+}
+
+bool NetworkConditioner::HasDue(Clock::time_point now) const {
+    return !inFlight.empty() && inFlight.begin()->first.first <= now;
+}
+
+void NetworkConditioner::Clear() {
+    inFlight.clear();
+    sentPackets = 0;
+    linkFreeAt = Clock::time_point();
+    lastReliableAt = Clock::time_point();
+}
+
+void NetworkConditioner::Log(Clock::time_point now, uint64_t packetNumber, size_t size, bool reliable,
+                             const char* action, Clock::time_point deliverAt) {
+    if (!log) {
+        return;
+    }
+
+    // Time since the conditions were set, packet number, size, fate and added latency, all in milliseconds
+    std::lock_guard<std::mutex> lock(*logMutex);
+    *log << std::chrono::duration<double, std::milli>(now - startTime).count() << " " << name << " #" << packetNumber
+         << " " << size << "B " << (reliable ? "reliable " : "") << action;
+    if (deliverAt > now) {
+        *log << " +" << std::chrono::duration<double, std::milli>(deliverAt - now).count() << "ms";
+    }
+    *log << "\n";
+}
+
+}
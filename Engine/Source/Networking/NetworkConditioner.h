@@ -0,0 +1,95 @@
+#ifndef NETWORKCONDITIONER_H
+#define NETWORKCONDITIONER_H
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <random>
+#include <string>
+#include <utility>
+
+namespace RiverCore {
+
+// Network conditions simulated on each direction of a connection
+struct NetworkConditions {
+    float delayMs = 0.0f;           // One-way latency added to every packet
+    float jitterMs = 0.0f;          // Random extra latency per packet, uniform between 0 and this
+    float dropRate = 0.0f;          // Fraction of unreliable packets lost
+    float reorderRate = 0.0f;       // Fraction of unreliable packets held back so later ones overtake them
+    float reorderDelayMs = 50.0f;   // How long reordered packets are held back
+    uint32_t bandwidth = 0;         // Bytes per second the link carries (0 = unlimited)
+    uint32_t seed = 1;              // Seed of the random choices, so a run can be repeated
+    std::string logPath;            // File every packet's fate is written to (empty = no log)
+
+    // Returns whether anything is simulated
+    bool IsEnabled() const {
+        return delayMs > 0.0f || jitterMs > 0.0f || dropRate > 0.0f || reorderRate > 0.0f || bandwidth > 0;
+    }
+
+    // Parses a comma-separated list such as "delay=80,jitter=20,drop=0.02,reorder=0.01,bandwidth=32000,seed=7"
+    // (keys: delay, jitter, drop, reorder, reorderdelay, bandwidth, seed, log); returns false on a bad entry
+    static bool Parse(const std::string& spec, NetworkConditions& conditions);
+    // Formats the conditions the way Parse reads them
+    std::string ToString() const;
+};
+
+// One direction of a simulated link between a socket and the code using it
+// Packets are held until their delivery time, which adds latency, jitter and the time the bandwidth takes to
+// carry them; unreliable packets may also be dropped (including when more than a second of traffic is queued)
+// or held back to be reordered. Reliable packets are never dropped and always arrive in the order they were sent.
+// Every decision comes from a seeded generator and can be logged, so runs can be reproduced.
+class NetworkConditioner {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Name identifies the direction in the log (e.g. "up", "down")
+    explicit NetworkConditioner(std::string name) : name(std::move(name)) {}
+
+    // Set the simulated conditions, resetting the link (seedOffset tells directions sharing conditions apart)
+    void SetConditions(const NetworkConditions& conditions, uint32_t seedOffset = 0);
+    // Set the stream every packet's fate is written to (null = no log; must outlive the conditioner)
+    void SetLog(std::ostream* log, std::mutex* logMutex);
+    // Returns whether the link simulates anything (packets pass straight through otherwise)
+    bool IsEnabled() const { return enabled; }
+
+    // Sends a packet into the link
+    void Push(std::string packet, bool reliable, Clock::time_point now);
+    // Takes the next packet whose delivery time has come; returns false if none has
+    bool Pop(Clock::time_point now, std::string& packet);
+    // Returns whether a packet is due by a point in time
+    bool HasDue(Clock::time_point now) const;
+    // Drops every packet in flight
+    void Clear();
+
+private:
+    std::string name;
+    NetworkConditions conditions;
+    bool enabled = false;
+    std::mt19937 random;
+
+    // Packets in flight by delivery time, then by send order
+    std::map<std::pair<Clock::time_point, uint64_t>, std::string> inFlight;
+    uint64_t sentPackets = 0;
+    // When the link finishes carrying the packets sent so far
+    Clock::time_point linkFreeAt;
+    // Delivery time of the last reliable packet, which later reliable packets may not overtake
+    Clock::time_point lastReliableAt;
+    // Start of the run, for log timestamps
+    Clock::time_point startTime;
+
+    std::ostream* log = nullptr;
+    std::mutex* logMutex = nullptr;
+
+    // Longest backlog the bandwidth limit queues before unreliable packets are dropped
+    static constexpr std::chrono::seconds MAX_BACKLOG{1};
+
+    // Writes a packet's fate to the log
+    void Log(Clock::time_point now, uint64_t packetNumber, size_t size, bool reliable, const char* action,
+             Clock::time_point deliverAt);
+};
+
+}
+
+#endif
@@ -1,4 +1,5 @@
 #include "NetworkManager.h"
+#include <algorithm>
 #include <iostream>
 
 namespace RiverCore {
@@ -19,11 +20,27 @@ bool NetworkManager::Connect(const std::string& serverAddress) {
     return true;
 }
 
+void NetworkManager::SetEntityManager(EntityManager* entityManager) {
+    entityManagerRef = entityManager;
+    predictor.SetEntityManager(entityManager);
+}
+
 void NetworkManager::Disconnect() {
     client.Disconnect();
+    if (entityManagerRef) {
+        for (const std::string& path : preloadedAssets) {
+            entityManagerRef->ReleasePreloadedTexture(path);
+        }
+    }
+    preloadedAssets.clear();
+    predictor.Reset();
+    hasInput = false;
+    inputSequence = 0;
+    predictionAccumulator = 0.0f;
     serverToLocalEntityMap.clear();
     localToServerEntityMap.clear();
     entitySpriteInfo.clear();
+    interpolator.Clear();
 }
 
 void NetworkManager::Update() {
@@ -33,28 +50,108 @@ void NetworkManager::Update() {
 
     // Update client networking
     client.Update();
+}
 
-    // Process entity spawn/despawn messages
-    ProcessPendingSpawns();
+void NetworkManager::UpdateEntities(float deltaTime) {
+    if (!IsConnected() || !entityManagerRef) {
+        return;
+    }
+
+    // Process entity spawn/despawn messages (despawns first, so an entity that left and re-entered a client's
+    // area of interest since the last update is respawned rather than removed)
     ProcessPendingDespawns();
+    ProcessPendingAssets();
+    ProcessPendingSpawns();
+
+    // Take over the local player once it is known
+    if (predictor.GetEntity() != localPlayerEntityId) {
+        predictor.SetEntity(localPlayerEntityId);
+    }
+
+    // Buffer the game states received since the last frame, correcting the local player from the newest one
+    std::vector<ReceivedSnapshot> received = client.GetReceivedSnapshots();
+    auto acked = std::find_if(received.rbegin(), received.rend(),
+        [](const ReceivedSnapshot& snapshot) { return snapshot.inputAck != 0; });
+    if (acked != received.rend()) {
+        ReconcileLocalPlayer(*acked);
+    }
+    for (ReceivedSnapshot& snapshot : received) {
+        interpolator.Add(std::move(snapshot.snapshot), snapshot.receivedAt);
+    }
 
-    // Get latest game state from server
-    GameStateSnapshot snapshot = client.GetLatestGameState();
+    // Run the local player ahead of the server
+    PredictLocalPlayer(deltaTime);
 
-    // Synchronize local entities with server state
-    if (!snapshot.entities.empty()) {
-        SyncEntitiesFromServer(snapshot);
+    // Synchronize local entities with the server state at this frame's render time
+    if (interpolator.Sample(SnapshotInterpolator::Clock::now(), interpolatedState) &&
+        !interpolatedState.entities.empty()) {
+        SyncEntitiesFromServer(interpolatedState);
     }
 }
 
+void NetworkManager::WaitForServer(int timeoutMs) {
+    client.WaitForMessages(timeoutMs);
+}
+
 bool NetworkManager::IsConnected() const {
     return client.IsConnected();
 }
 
-void NetworkManager::SendInput(const std::unordered_map<std::string, bool>& buttons,
-                                const std::unordered_map<std::string, float>& axes) {
-    if (IsConnected()) {
-        client.SendInput(buttons, axes);
+void NetworkManager::SendInput(const InputState& input) {
+    if (!IsConnected()) {
+        return;
+    }
+
+    currentInput = input;
+    hasInput = true;
+
+    // Predicted input goes out with the next prediction step
+    if (!predictor.IsActive()) {
+        client.SendInput(input);
+    }
+}
+
+void NetworkManager::PredictLocalPlayer(float deltaTime) {
+    if (!predictor.IsActive() || !hasInput) {
+        predictionAccumulator = 0.0f;
+        return;
+    }
+
+    predictionAccumulator += deltaTime;
+    while (predictionAccumulator >= PREDICTION_TIMESTEP) {
+        predictionAccumulator -= PREDICTION_TIMESTEP;
+
+        InputState command = currentInput;
+        command.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        command.sequence = ++inputSequence;
+        client.QueueInputCommand(command);
+
+        if (!predictor.Predict(command, PREDICTION_TIMESTEP)) {
+            // Not predictable, so the input goes back to being streamed as is
+            client.SendInput(currentInput);
+            predictionAccumulator = 0.0f;
+            return;
+        }
+    }
+}
+
+void NetworkManager::ReconcileLocalPlayer(const ReceivedSnapshot& received) {
+    if (!predictor.IsActive()) {
+        return;
+    }
+
+    auto server = localToServerEntityMap.find(predictor.GetEntity());
+    if (server == localToServerEntityMap.end()) {
+        return;
+    }
+
+    // Entities are sorted by ID
+    const std::vector<EntitySnapshot>& entities = received.snapshot->entities;
+    auto entity = std::lower_bound(entities.begin(), entities.end(), server->second,
+        [](const EntitySnapshot& snapshot, uint32_t entityID) { return snapshot.entityID < entityID; });
+    if (entity != entities.end() && entity->entityID == server->second) {
+        predictor.Reconcile(*entity, received.inputAck);
     }
 }
 
@@ -126,6 +223,15 @@ void NetworkManager::ProcessPendingSpawns() {
     }
 }
 
+void NetworkManager::ProcessPendingAssets() {
+    // Each asset is loaded once when the server registers it, so spawns using it find it cached
+    for (std::string& path : client.GetPendingAssets()) {
+        if (entityManagerRef->PreloadTexture(path)) {
+            preloadedAssets.push_back(std::move(path));
+        }
+    }
+}
+
 void NetworkManager::ProcessPendingDespawns() {
     if (!entityManagerRef) {
         return;
@@ -170,19 +276,21 @@ void NetworkManager::SyncEntitiesFromServer(const GameStateSnapshot& snapshot) {
 
         uint32_t localEntityID = serverToLocalEntityMap[entitySnap.entityID];
 
-        // Check if entity exists locally (by local ID)
-        Entity* entity = entityManagerRef->GetEntityByID(localEntityID);
-
-        if (entity) {
-            // Update entity transform from server
-            entity->position = entitySnap.position;
-            entity->velocity = entitySnap.velocity;
-            entity->scale = entitySnap.scale;
-            entity->rotation = entitySnap.rotation;
-            entity->flipX = entitySnap.flipX;
-            entity->flipY = entitySnap.flipY;
-            entity->currentFrame = entitySnap.currentFrame;
+        // The predicted player is corrected by reconciliation instead
+        if (localEntityID == predictor.GetEntity() && predictor.IsActive()) {
+            continue;
         }
+
+        // Update entity transform from server (no-op if the entity no longer exists locally)
+        entityManagerRef->ModifyEntity(localEntityID, [&entitySnap](Entity& entity) {
+            entity.position = entitySnap.position;
+            entity.velocity = entitySnap.velocity;
+            entity.scale = entitySnap.scale;
+            entity.rotation = entitySnap.rotation;
+            entity.flipX = entitySnap.flipX;
+            entity.flipY = entitySnap.flipY;
+            entity.currentFrame = entitySnap.currentFrame;
+        });
     }
 }
 
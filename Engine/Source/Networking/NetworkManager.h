@@ -3,6 +3,8 @@
 
 #include "Client.h"
 #include "NetworkProtocol.h"
+#include "SnapshotInterpolator.h"
+#include "PlayerPredictor.h"
 #include "Renderer/EntityManager.h"
 #include <unordered_map>
 #include <unordered_set>
@@ -19,17 +21,27 @@ public:
     bool Connect(const std::string& serverAddress);
     // Disconnects the client from a server
     void Disconnect();
-    // Updates the local client
+    // Updates the local client (network thread)
     void Update();
+    // Applies the server's spawns, despawns and interpolated state to local entities, and predicts the local
+    // player over the frame's time (once per rendered frame)
+    void UpdateEntities(float deltaTime);
+    // Waits until the server pushes new state or the timeout expires
+    void WaitForServer(int timeoutMs);
     // Returns if the local client is connected to a server
     bool IsConnected() const;
 
     // Set EntityManager reference for entity manipulation
-    void SetEntityManager(EntityManager* entityManager) { entityManagerRef = entityManager; }
+    void SetEntityManager(EntityManager* entityManager);
+    // Set the physics used to predict the local player's body
+    void SetPhysics(const Physics* physics) { predictor.SetPhysics(physics); }
+    // Set the handler applying input to the local player, the same one the server runs (GameInterface::OnPlayerInput)
+    // With a handler the local player is predicted and input is sent as one command per prediction step
+    void SetPlayerInputHandler(PlayerPredictor::InputHandler handler) { predictor.SetInputHandler(std::move(handler)); }
 
     // Send input to server (client mode)
-    void SendInput(const std::unordered_map<std::string, bool>& buttons,
-                   const std::unordered_map<std::string, float>& axes = {});
+    // While the local player is predicted this sets the input applied by each following prediction step
+    void SendInput(const InputState& input);
 
     // Get client ID
     uint32_t GetClientId() const;
@@ -37,6 +49,15 @@ public:
     // Get local player entity ID (client mode)
     uint32_t GetLocalPlayerEntity() const { return localPlayerEntityId; }
 
+    // Set how far in the past server state is rendered, in seconds (longer hides more jitter and loss)
+    void SetInterpolationDelay(float seconds) { interpolator.SetDelay(seconds); }
+    // Get how far in the past server state is rendered, in seconds
+    float GetInterpolationDelay() const { return interpolator.GetDelay(); }
+
+    // Simulate latency, jitter, loss, reordering and a bandwidth cap on the connection (default conditions turn
+    // it off), e.g. to tune the interpolation delay on loopback
+    void SetNetworkConditions(const NetworkConditions& conditions) { client.SetNetworkConditions(conditions); }
+
 private:
     // Client instance for server communication
     Client client;
@@ -54,12 +75,35 @@ private:
     // Track entities spawned by network
     std::unordered_set<uint32_t> spawnedEntities;
 
+    // Received server states, blended at render time
+    SnapshotInterpolator interpolator;
+    GameStateSnapshot interpolatedState;
+
+    // Local player prediction (render thread only)
+    PlayerPredictor predictor;
+    InputState currentInput;
+    bool hasInput = false;
+    uint32_t inputSequence = 0;
+    float predictionAccumulator = 0.0f;
+    // Time step of each input command, matching the server tick
+    static constexpr float PREDICTION_TIMESTEP = 1.0f / 60.0f;
+
+    // Runs the prediction steps due over a frame, sending each step's input command
+    void PredictLocalPlayer(float deltaTime);
+    // Corrects the predicted player from the newest snapshot acknowledging one of its commands
+    void ReconcileLocalPlayer(const ReceivedSnapshot& received);
+
     // Synchronize entities from server state
     void SyncEntitiesFromServer(const GameStateSnapshot& snapshot);
 
     // Process pending spawn/despawn messages from server
     void ProcessPendingSpawns();
     void ProcessPendingDespawns();
+    // Load the textures of the server's newly registered assets
+    void ProcessPendingAssets();
+
+    // Sprites of the server's asset table held in the texture cache while connected
+    std::vector<std::string> preloadedAssets;
 
     // Sprite sheet cache
     struct SpriteInfo {
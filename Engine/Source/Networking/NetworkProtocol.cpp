@@ -0,0 +1,558 @@
+#include "NetworkProtocol.h"
+#include <sstream>
+
+namespace RiverCore {
+
+namespace {
+
+// Size of one binary entity snapshot record
+constexpr size_t ENTITY_SNAPSHOT_SIZE = 37;
+
+// Entity snapshot flag bits
+constexpr uint8_t SNAPSHOT_FLIP_X = 1 << 0;
+constexpr uint8_t SNAPSHOT_FLIP_Y = 1 << 1;
+
+std::string SerializeEntityText(const EntitySnapshot& snapshot) {
+    std::ostringstream oss;
+    oss << snapshot.entityID << " "
+        << snapshot.position.x << " " << snapshot.position.y << " "
+        << snapshot.velocity.x << " " << snapshot.velocity.y << " "
+        << snapshot.scale.x << " " << snapshot.scale.y << " "
+        << snapshot.rotation << " "
+        << (snapshot.flipX ? 1 : 0) << " " << (snapshot.flipY ? 1 : 0) << " "
+        << snapshot.currentFrame;
+    return oss.str();
+}
+
+EntitySnapshot DeserializeEntityText(std::istringstream& iss) {
+    EntitySnapshot snapshot;
+    int flipXInt, flipYInt;
+
+    iss >> snapshot.entityID
+        >> snapshot.position.x >> snapshot.position.y
+        >> snapshot.velocity.x >> snapshot.velocity.y
+        >> snapshot.scale.x >> snapshot.scale.y
+        >> snapshot.rotation
+        >> flipXInt >> flipYInt
+        >> snapshot.currentFrame;
+
+    snapshot.flipX = (flipXInt != 0);
+    snapshot.flipY = (flipYInt != 0);
+
+    return snapshot;
+}
+
+// Splits a binary message at the start of a range; returns false if the header is invalid or the range is truncated
+bool ParseBinaryMessage(const char* data, size_t size, MessageType& type, std::string& payload, size_t& messageSize) {
+    if (size < MESSAGE_HEADER_SIZE) {
+        return false;
+    }
+
+    ByteReader header(data, MESSAGE_HEADER_SIZE);
+    uint8_t magic = header.ReadU8();
+    uint8_t version = header.ReadU8();
+    uint8_t typeByte = header.ReadU8();
+    header.ReadU8();  // Flags (reserved)
+    uint32_t payloadSize = header.ReadU32();
+
+    // The version only changes on breaking layout changes; additive fields go into existing sections
+    if (magic != PROTOCOL_MAGIC || version != PROTOCOL_VERSION) {
+        return false;
+    }
+    if (size - MESSAGE_HEADER_SIZE < payloadSize) {
+        return false;
+    }
+
+    type = static_cast<MessageType>(typeByte);
+    payload.assign(data + MESSAGE_HEADER_SIZE, payloadSize);
+    messageSize = MESSAGE_HEADER_SIZE + payloadSize;
+    return true;
+}
+
+bool ParseTextMessage(const std::string& message, MessageType& type, std::string& payload) {
+    std::istringstream iss(message);
+    int typeInt;
+
+    if (!(iss >> typeInt)) {
+        return false;
+    }
+
+    type = static_cast<MessageType>(typeInt);
+
+    // Get the rest of the message as payload
+    if (iss.peek() == ' ') {
+        iss.ignore();
+    }
+    payload.clear();
+    std::getline(iss, payload);
+
+    return true;
+}
+
+}
+
+void InputState::SetButton(InputActionID button, bool pressed) {
+    if (button >= MAX_BUTTON_ACTIONS) {
+        return;
+    }
+
+    uint64_t bit = uint64_t(1) << button;
+    buttons = pressed ? (buttons | bit) : (buttons & ~bit);
+}
+
+void InputState::SetAxis(InputActionID axis, float value) {
+    if (axis < MAX_AXIS_ACTIONS) {
+        axes[axis] = value;
+    }
+}
+
+std::string InputState::Serialize(WireFormat format) const {
+    if (format == WireFormat::TEXT) {
+        // Text carries the names of the held buttons and non-zero axes
+        std::vector<std::string> buttonNames;
+        for (size_t i = 0; i < MAX_BUTTON_ACTIONS; ++i) {
+            std::string name = IsPressed(static_cast<InputActionID>(i)) ?
+                InputActions::GetButtonName(static_cast<InputActionID>(i)) : std::string();
+            if (!name.empty()) {
+                buttonNames.push_back(std::move(name));
+            }
+        }
+        std::vector<std::pair<std::string, float>> axisValues;
+        for (size_t i = 0; i < MAX_AXIS_ACTIONS; ++i) {
+            std::string name = axes[i] != 0.0f ? InputActions::GetAxisName(static_cast<InputActionID>(i)) : std::string();
+            if (!name.empty()) {
+                axisValues.emplace_back(std::move(name), axes[i]);
+            }
+        }
+
+        std::ostringstream oss;
+        oss << clientID << " " << timestamp << " " << buttonNames.size() << " " << axisValues.size();
+
+        for (const std::string& name : buttonNames) {
+            oss << " " << name << " 1";
+        }
+
+        for (const auto& [name, value] : axisValues) {
+            oss << " " << name << " " << value;
+        }
+
+        return oss.str();
+    }
+
+    // Trailing zero axes are left out
+    uint8_t axisCount = static_cast<uint8_t>(MAX_AXIS_ACTIONS);
+    while (axisCount > 0 && axes[axisCount - 1] == 0.0f) {
+        --axisCount;
+    }
+
+    std::string data;
+    data.reserve(25 + axisCount * sizeof(float));
+    ByteWriter writer(data);
+    writer.WriteU32(clientID);
+    writer.WriteU64(timestamp);
+    writer.WriteU32(sequence);
+    writer.WriteU64(buttons);
+    writer.WriteU8(axisCount);
+    for (uint8_t i = 0; i < axisCount; ++i) {
+        writer.WriteF32(axes[i]);
+    }
+
+    return data;
+}
+
+InputState InputState::Deserialize(const std::string& data, WireFormat format) {
+    InputState input;
+
+    if (format == WireFormat::TEXT) {
+        std::istringstream iss(data);
+
+        size_t buttonCount, axesCount;
+        iss >> input.clientID >> input.timestamp >> buttonCount >> axesCount;
+
+        // Names this side has not registered are ignored
+        for (size_t i = 0; i < buttonCount; ++i) {
+            std::string key;
+            int value;
+            iss >> key >> value;
+            input.SetButton(InputActions::FindButton(key), value != 0);
+        }
+
+        for (size_t i = 0; i < axesCount; ++i) {
+            std::string key;
+            float value;
+            iss >> key >> value;
+            input.SetAxis(InputActions::FindAxis(key), value);
+        }
+
+        return input;
+    }
+
+    ByteReader reader(data);
+    input.clientID = reader.ReadU32();
+    input.timestamp = reader.ReadU64();
+    input.sequence = reader.ReadU32();
+    input.buttons = reader.ReadU64();
+
+    // Axes beyond the ones this side knows are skipped
+    uint8_t axisCount = reader.ReadU8();
+    for (uint8_t i = 0; i < axisCount && !reader.Failed(); ++i) {
+        float value = reader.ReadF32();
+        if (!reader.Failed()) {
+            input.SetAxis(i, value);
+        }
+    }
+
+    return input;
+}
+
+void EntitySnapshot::Write(ByteWriter& writer) const {
+    writer.WriteU32(entityID);
+    writer.WriteF32(position.x);
+    writer.WriteF32(position.y);
+    writer.WriteF32(velocity.x);
+    writer.WriteF32(velocity.y);
+    writer.WriteF32(scale.x);
+    writer.WriteF32(scale.y);
+    writer.WriteF32(rotation);
+    writer.WriteU8((flipX ? SNAPSHOT_FLIP_X : 0) | (flipY ? SNAPSHOT_FLIP_Y : 0));
+    writer.WriteI32(currentFrame);
+}
+
+EntitySnapshot EntitySnapshot::Read(ByteReader& reader) {
+    EntitySnapshot snapshot;
+    snapshot.entityID = reader.ReadU32();
+    snapshot.position.x = reader.ReadF32();
+    snapshot.position.y = reader.ReadF32();
+    snapshot.velocity.x = reader.ReadF32();
+    snapshot.velocity.y = reader.ReadF32();
+    snapshot.scale.x = reader.ReadF32();
+    snapshot.scale.y = reader.ReadF32();
+    snapshot.rotation = reader.ReadF32();
+    uint8_t flags = reader.ReadU8();
+    snapshot.flipX = (flags & SNAPSHOT_FLIP_X) != 0;
+    snapshot.flipY = (flags & SNAPSHOT_FLIP_Y) != 0;
+    snapshot.currentFrame = reader.ReadI32();
+    return snapshot;
+}
+
+std::string GameStateSnapshot::Serialize(WireFormat format) const {
+    if (format == WireFormat::TEXT) {
+        std::ostringstream oss;
+        oss << timestamp << " " << entities.size() << " " << playerEntityBindings.size();
+
+        for (const auto& entity : entities) {
+            oss << " " << SerializeEntityText(entity);
+        }
+
+        for (const auto& [clientID, entityID] : playerEntityBindings) {
+            oss << " " << clientID << " " << entityID;
+        }
+
+        return oss.str();
+    }
+
+    std::string data;
+    data.reserve(12 + 2 * 8 + entities.size() * ENTITY_SNAPSHOT_SIZE + playerEntityBindings.size() * 8);
+    ByteWriter writer(data);
+    writer.WriteU64(timestamp);
+    writer.WriteU32(snapshotID);
+
+    size_t section = writer.BeginSection();
+    writer.WriteU32(static_cast<uint32_t>(entities.size()));
+    for (const auto& entity : entities) {
+        entity.Write(writer);
+    }
+    writer.EndSection(section);
+
+    section = writer.BeginSection();
+    writer.WriteU32(static_cast<uint32_t>(playerEntityBindings.size()));
+    for (const auto& [clientID, entityID] : playerEntityBindings) {
+        writer.WriteU32(clientID);
+        writer.WriteU32(entityID);
+    }
+    writer.EndSection(section);
+
+    return data;
+}
+
+GameStateSnapshot GameStateSnapshot::Deserialize(const std::string& data, WireFormat format) {
+    GameStateSnapshot snapshot;
+
+    if (format == WireFormat::TEXT) {
+        std::istringstream iss(data);
+
+        size_t entityCount, bindingCount;
+        iss >> snapshot.timestamp >> entityCount >> bindingCount;
+
+        for (size_t i = 0; i < entityCount; ++i) {
+            snapshot.entities.push_back(DeserializeEntityText(iss));
+        }
+
+        for (size_t i = 0; i < bindingCount; ++i) {
+            uint32_t clientID, entityID;
+            iss >> clientID >> entityID;
+            snapshot.playerEntityBindings[clientID] = entityID;
+        }
+
+        return snapshot;
+    }
+
+    ByteReader reader(data);
+    snapshot.timestamp = reader.ReadU64();
+    snapshot.snapshotID = reader.ReadU32();
+
+    ByteReader entitySection = reader.ReadSection();
+    uint32_t entityCount = entitySection.ReadU32();
+    // Never trust the count further than the section can actually hold
+    if (entityCount <= entitySection.Remaining() / ENTITY_SNAPSHOT_SIZE) {
+        snapshot.entities.reserve(entityCount);
+        for (uint32_t i = 0; i < entityCount; ++i) {
+            snapshot.entities.push_back(EntitySnapshot::Read(entitySection));
+        }
+    }
+
+    ByteReader bindingSection = reader.ReadSection();
+    uint32_t bindingCount = bindingSection.ReadU32();
+    for (uint32_t i = 0; i < bindingCount && !bindingSection.Failed(); ++i) {
+        uint32_t clientID = bindingSection.ReadU32();
+        uint32_t entityID = bindingSection.ReadU32();
+        if (!bindingSection.Failed()) {
+            snapshot.playerEntityBindings[clientID] = entityID;
+        }
+    }
+
+    return snapshot;
+}
+
+std::string EntitySpawnInfo::Serialize(WireFormat format) const {
+    if (format == WireFormat::TEXT) {
+        std::ostringstream oss;
+        oss << entityID << " "
+            << "\"" << spritePath << "\" "
+            << totalFrames << " "
+            << fps << " "
+            << position.x << " " << position.y << " "
+            << scale.x << " " << scale.y << " "
+            << rotation << " "
+            << (physEnabled ? 1 : 0) << " "
+            << colliderType << " "
+            << ownerClientID;
+        return oss.str();
+    }
+
+    std::string data;
+    ByteWriter writer(data);
+    writer.WriteU32(entityID);
+    writer.WriteU32(spriteID);
+    writer.WriteI32(totalFrames);
+    writer.WriteF32(fps);
+    writer.WriteF32(position.x);
+    writer.WriteF32(position.y);
+    writer.WriteF32(scale.x);
+    writer.WriteF32(scale.y);
+    writer.WriteF32(rotation);
+    writer.WriteBool(physEnabled);
+    writer.WriteI32(colliderType);
+    writer.WriteU32(ownerClientID);
+    return data;
+}
+
+EntitySpawnInfo EntitySpawnInfo::Deserialize(const std::string& data, WireFormat format) {
+    EntitySpawnInfo info;
+
+    if (format == WireFormat::TEXT) {
+        std::istringstream iss(data);
+        int physInt;
+
+        // Read entityID
+        iss >> info.entityID;
+
+        // Read quoted sprite path
+        iss.ignore();  // Skip space before quote
+        std::getline(iss, info.spritePath, '"');
+        std::getline(iss, info.spritePath, '"');
+
+        // Read remaining fields
+        iss >> info.totalFrames
+            >> info.fps
+            >> info.position.x >> info.position.y
+            >> info.scale.x >> info.scale.y
+            >> info.rotation
+            >> physInt
+            >> info.colliderType
+            >> info.ownerClientID;
+
+        info.physEnabled = (physInt != 0);
+
+        return info;
+    }
+
+    ByteReader reader(data);
+    info.entityID = reader.ReadU32();
+    info.spriteID = reader.ReadU32();
+    info.totalFrames = reader.ReadI32();
+    info.fps = reader.ReadF32();
+    info.position.x = reader.ReadF32();
+    info.position.y = reader.ReadF32();
+    info.scale.x = reader.ReadF32();
+    info.scale.y = reader.ReadF32();
+    info.rotation = reader.ReadF32();
+    info.physEnabled = reader.ReadBool();
+    info.colliderType = reader.ReadI32();
+    info.ownerClientID = reader.ReadU32();
+    return info;
+}
+
+std::string SerializeID(uint32_t id, WireFormat format) {
+    if (format == WireFormat::TEXT) {
+        return std::to_string(id);
+    }
+
+    std::string data;
+    ByteWriter writer(data);
+    writer.WriteU32(id);
+    return data;
+}
+
+uint32_t DeserializeID(const std::string& data, WireFormat format) {
+    if (format == WireFormat::TEXT) {
+        // Malformed IDs read as 0 rather than throwing
+        std::istringstream iss(data);
+        uint32_t id = 0;
+        if ((iss >> std::ws).peek() == '-' || !(iss >> id) || !(iss >> std::ws).eof()) {
+            return 0;
+        }
+        return id;
+    }
+
+    ByteReader reader(data);
+    return reader.ReadU32();
+}
+
+std::string InputAck::Serialize(WireFormat format) const {
+    if (format == WireFormat::TEXT) {
+        return std::to_string(sequence) + " " + std::to_string(snapshotID);
+    }
+
+    std::string data;
+    ByteWriter writer(data);
+    writer.WriteU32(sequence);
+    writer.WriteU32(snapshotID);
+    return data;
+}
+
+InputAck InputAck::Deserialize(const std::string& data, WireFormat format) {
+    InputAck ack;
+
+    if (format == WireFormat::TEXT) {
+        std::istringstream iss(data);
+        iss >> ack.sequence >> ack.snapshotID;
+        return ack;
+    }
+
+    ByteReader reader(data);
+    ack.sequence = reader.ReadU32();
+    ack.snapshotID = reader.ReadU32();
+    return ack;
+}
+
+std::string AssetTableUpdate::Serialize() const {
+    std::string data;
+    ByteWriter writer(data);
+    writer.WriteU32(firstID);
+    writer.WriteU32(static_cast<uint32_t>(paths.size()));
+    for (const std::string& path : paths) {
+        writer.WriteString(path);
+    }
+    return data;
+}
+
+AssetTableUpdate AssetTableUpdate::Deserialize(const std::string& data) {
+    AssetTableUpdate update;
+    ByteReader reader(data);
+    update.firstID = reader.ReadU32();
+    uint32_t count = reader.ReadU32();
+    for (uint32_t i = 0; i < count && !reader.Failed(); ++i) {
+        std::string path = reader.ReadString();
+        if (!reader.Failed()) {
+            update.paths.push_back(std::move(path));
+        }
+    }
+    return update;
+}
+
+std::string CreateMessage(MessageType type, const std::string& payload, WireFormat format) {
+    std::string message;
+    AppendMessage(message, type, payload, format);
+    return message;
+}
+
+void AppendMessage(std::string& buffer, MessageType type, const std::string& payload, WireFormat format) {
+    if (format == WireFormat::TEXT) {
+        if (!buffer.empty()) {
+            buffer += '\n';
+        }
+        buffer += std::to_string(static_cast<int>(type));
+        if (!payload.empty()) {
+            buffer += ' ';
+            buffer += payload;
+        }
+        return;
+    }
+
+    ByteWriter writer(buffer);
+    writer.WriteU8(PROTOCOL_MAGIC);
+    writer.WriteU8(PROTOCOL_VERSION);
+    writer.WriteU8(static_cast<uint8_t>(type));
+    writer.WriteU8(0);
+    writer.WriteU32(static_cast<uint32_t>(payload.size()));
+    writer.WriteBytes(payload.data(), payload.size());
+}
+
+bool ParseMessage(const std::string& message, MessageType& type, std::string& payload) {
+    WireFormat format;
+    return ParseMessage(message, type, payload, format);
+}
+
+bool ParseMessage(const std::string& message, MessageType& type, std::string& payload, WireFormat& format) {
+    size_t offset = 0;
+    if (!message.empty() && static_cast<uint8_t>(message[0]) != PROTOCOL_MAGIC) {
+        // Text messages are a single line
+        format = WireFormat::TEXT;
+        return ParseTextMessage(message, type, payload);
+    }
+    return ReadMessage(message, offset, type, payload, format);
+}
+
+bool ReadMessage(const std::string& buffer, size_t& offset, MessageType& type, std::string& payload, WireFormat& format) {
+    if (offset >= buffer.size()) {
+        return false;
+    }
+
+    if (static_cast<uint8_t>(buffer[offset]) == PROTOCOL_MAGIC) {
+        format = WireFormat::BINARY;
+        size_t messageSize = 0;
+        if (!ParseBinaryMessage(buffer.data() + offset, buffer.size() - offset, type, payload, messageSize)) {
+            return false;
+        }
+        offset += messageSize;
+        return true;
+    }
+
+    // Text messages are separated by newlines; skip empty lines
+    format = WireFormat::TEXT;
+    while (offset < buffer.size()) {
+        size_t end = buffer.find('\n', offset);
+        if (end == std::string::npos) {
+            end = buffer.size();
+        }
+        std::string line = buffer.substr(offset, end - offset);
+        offset = end < buffer.size() ? end + 1 : end;
+        if (!line.empty()) {
+            return ParseTextMessage(line, type, payload);
+        }
+    }
+    return false;
+}
+
+}
@@ -2,60 +2,56 @@
 #define NETWORKPROTOCOL_H
 
 #include "Math/Math.h"
+#include "ByteStream.h"
+#include "InputActions.h"
 #include <unordered_map>
+#include <array>
 #include <vector>
 #include <string>
-#include <sstream>
 #include <cstdint>
 
 namespace RiverCore {
 
+// Encoding used for a protocol message and its payload
+enum class WireFormat {
+    BINARY,     // Versioned little-endian encoding (default)
+    TEXT        // Legacy space-separated text; only recognized so the server can turn such clients away
+};
+
+// Binary messages start with a fixed 8-byte header:
+// magic (u8), version (u8), message type (u8), flags (u8), payload size (u32)
+// The magic byte can never start a text message (those begin with a decimal message type)
+constexpr uint8_t PROTOCOL_MAGIC = 0xB7;
+constexpr uint8_t PROTOCOL_VERSION = 4;
+constexpr size_t MESSAGE_HEADER_SIZE = 8;
+
 // Generic input state
+// Buttons and axes are indexed by the action IDs of InputActions, so copying and encoding input never allocates
 struct InputState {
     uint32_t clientID = 0;
-    std::unordered_map<std::string, bool> buttons;
-    std::unordered_map<std::string, float> axes;
+    uint64_t buttons = 0;                           // Bit per button action, set while the button is held
+    std::array<float, MAX_AXIS_ACTIONS> axes{};     // Value per axis action
     uint64_t timestamp = 0;
+    uint32_t sequence = 0;  // Input command number for client prediction (0 = latest state, not sequenced)
+
+    // Gets whether a button action is held
+    bool IsPressed(InputActionID button) const { return button < MAX_BUTTON_ACTIONS && ((buttons >> button) & 1); }
+    // Sets whether a button action is held
+    void SetButton(InputActionID button, bool pressed);
+    // Gets the value of an axis action
+    float GetAxis(InputActionID axis) const { return axis < MAX_AXIS_ACTIONS ? axes[axis] : 0.0f; }
+    // Sets the value of an axis action
+    void SetAxis(InputActionID axis, float value);
+
+    // Lookups by action name through InputActions (unregistered names read as released and 0)
+    bool IsPressed(const std::string& button) const { return IsPressed(InputActions::FindButton(button)); }
+    float GetAxis(const std::string& axis) const { return GetAxis(InputActions::FindAxis(axis)); }
 
     // Serialization
-    std::string Serialize() const {
-        std::ostringstream oss;
-        oss << clientID << " " << timestamp << " " << buttons.size() << " " << axes.size();
-
-        for (const auto& [key, value] : buttons) {
-            oss << " " << key << " " << (value ? 1 : 0);
-        }
-
-        for (const auto& [key, value] : axes) {
-            oss << " " << key << " " << value;
-        }
-
-        return oss.str();
-    }
-
-    static InputState Deserialize(const std::string& data) {
-        InputState input;
-        std::istringstream iss(data);
-
-        size_t buttonCount, axesCount;
-        iss >> input.clientID >> input.timestamp >> buttonCount >> axesCount;
-
-        for (size_t i = 0; i < buttonCount; ++i) {
-            std::string key;
-            int value;
-            iss >> key >> value;
-            input.buttons[key] = (value != 0);
-        }
-
-        for (size_t i = 0; i < axesCount; ++i) {
-            std::string key;
-            float value;
-            iss >> key >> value;
-            input.axes[key] = value;
-        }
-
-        return input;
-    }
+    // Binary layout: client ID, timestamp, sequence and button bits, then an axis count and that many axis values
+    // (trailing zero axes are left out); the text format carries action names and no sequence
+    std::string Serialize(WireFormat format = WireFormat::BINARY) const;
+    static InputState Deserialize(const std::string& data, WireFormat format = WireFormat::BINARY);
 };
 
 // Generic entity snapshot
@@ -69,85 +65,29 @@ struct EntitySnapshot {
     bool flipY = false;
     int currentFrame = 0;
 
-    // Serialization
-    std::string Serialize() const {
-        std::ostringstream oss;
-        oss << entityID << " "
-            << position.x << " " << position.y << " "
-            << velocity.x << " " << velocity.y << " "
-            << scale.x << " " << scale.y << " "
-            << rotation << " "
-            << (flipX ? 1 : 0) << " " << (flipY ? 1 : 0) << " "
-            << currentFrame;
-        return oss.str();
-    }
-
-    static EntitySnapshot Deserialize(std::istringstream& iss) {
-        EntitySnapshot snapshot;
-        int flipXInt, flipYInt;
-
-        iss >> snapshot.entityID
-            >> snapshot.position.x >> snapshot.position.y
-            >> snapshot.velocity.x >> snapshot.velocity.y
-            >> snapshot.scale.x >> snapshot.scale.y
-            >> snapshot.rotation
-            >> flipXInt >> flipYInt
-            >> snapshot.currentFrame;
-
-        snapshot.flipX = (flipXInt != 0);
-        snapshot.flipY = (flipYInt != 0);
-
-        return snapshot;
-    }
+    // Binary serialization (fixed 37-byte record)
+    void Write(ByteWriter& writer) const;
+    static EntitySnapshot Read(ByteReader& reader);
 };
 
 // Complete game state snapshot
 struct GameStateSnapshot {
     std::vector<EntitySnapshot> entities;
     std::unordered_map<uint32_t, uint32_t> playerEntityBindings;  // clientID -> entityID
-    uint64_t timestamp = 0;
+    uint64_t timestamp = 0;   // Server time of the tick in milliseconds, used to place the snapshot for interpolation
+    uint32_t snapshotID = 0;  // Server tick the snapshot was captured in (0 = none), used to ack delta baselines
 
     // Serialization
-    std::string Serialize() const {
-        std::ostringstream oss;
-        oss << timestamp << " " << entities.size() << " " << playerEntityBindings.size();
-
-        for (const auto& entity : entities) {
-            oss << " " << entity.Serialize();
-        }
-
-        for (const auto& [clientID, entityID] : playerEntityBindings) {
-            oss << " " << clientID << " " << entityID;
-        }
-
-        return oss.str();
-    }
-
-    static GameStateSnapshot Deserialize(const std::string& data) {
-        GameStateSnapshot snapshot;
-        std::istringstream iss(data);
-
-        size_t entityCount, bindingCount;
-        iss >> snapshot.timestamp >> entityCount >> bindingCount;
-
-        for (size_t i = 0; i < entityCount; ++i) {
-            snapshot.entities.push_back(EntitySnapshot::Deserialize(iss));
-        }
-
-        for (size_t i = 0; i < bindingCount; ++i) {
-            uint32_t clientID, entityID;
-            iss >> clientID >> entityID;
-            snapshot.playerEntityBindings[clientID] = entityID;
-        }
-
-        return snapshot;
-    }
+    // Binary layout: timestamp and snapshot ID, then an entity section and a binding section, each length-prefixed
+    std::string Serialize(WireFormat format = WireFormat::BINARY) const;
+    static GameStateSnapshot Deserialize(const std::string& data, WireFormat format = WireFormat::BINARY);
 };
 
 // Entity spawn information
 struct EntitySpawnInfo {
     uint32_t entityID = 0;
-    std::string spritePath;
+    std::string spritePath;      // Resolved by the client from spriteID; only the text format carries it
+    uint32_t spriteID = 0;       // ID of spritePath in the server's asset table (0 = unassigned)
     int totalFrames = 1;
     float fps = 0.0f;
     Vec2 position = Vec2::zero();
@@ -158,48 +98,8 @@ struct EntitySpawnInfo {
     uint32_t ownerClientID = 0;  // 0 = shared, non-zero = owned by that client
 
     // Serialization
-    std::string Serialize() const {
-        std::ostringstream oss;
-        oss << entityID << " "
-            << "\"" << spritePath << "\" "
-            << totalFrames << " "
-            << fps << " "
-            << position.x << " " << position.y << " "
-            << scale.x << " " << scale.y << " "
-            << rotation << " "
-            << (physEnabled ? 1 : 0) << " "
-            << colliderType << " "
-            << ownerClientID;
-        return oss.str();
-    }
-
-    static EntitySpawnInfo Deserialize(const std::string& data) {
-        EntitySpawnInfo info;
-        std::istringstream iss(data);
-        int physInt;
-
-        // Read entityID
-        iss >> info.entityID;
-
-        // Read quoted sprite path
-        iss.ignore();  // Skip space before quote
-        std::getline(iss, info.spritePath, '"');
-        std::getline(iss, info.spritePath, '"');
-
-        // Read remaining fields
-        iss >> info.totalFrames
-            >> info.fps
-            >> info.position.x >> info.position.y
-            >> info.scale.x >> info.scale.y
-            >> info.rotation
-            >> physInt
-            >> info.colliderType
-            >> info.ownerClientID;
-
-        info.physEnabled = (physInt != 0);
-
-        return info;
-    }
+    std::string Serialize(WireFormat format = WireFormat::BINARY) const;
+    static EntitySpawnInfo Deserialize(const std::string& data, WireFormat format = WireFormat::BINARY);
 };
 
 // Message types for network protocol
@@ -209,38 +109,55 @@ enum class MessageType {
     INPUT,              // Client -> Server
     GAME_STATE,         // Server -> Client
     SPAWN_ENTITY,       // Server -> Client (spawn new entity)
-    DESPAWN_ENTITY      // Server -> Client (remove entity)
+    DESPAWN_ENTITY,     // Server -> Client (remove entity)
+    CONNECTED,          // Server -> Client (connection accepted, payload = assigned client ID)
+    GAME_STATE_DELTA,   // Server -> Client (game state encoded against an acknowledged snapshot)
+    SNAPSHOT_ACK,       // Client -> Server (latest snapshot ID the client holds, payload = snapshot ID)
+    SNAPSHOT_CONFIG,    // Server -> Client (quantization used by GAME_STATE_DELTA, sent before the first state)
+    INPUT_ACK,          // Server -> Client (last input command applied before a snapshot, sent with that snapshot)
+    WORLD_CHUNK,        // Server -> Client (batch of compact spawn records streamed to a joining client)
+    ASSET_TABLE         // Server -> Client (asset paths by ID, sent before the first spawn referencing them)
 };
 
-// Helper to create protocol messages
-inline std::string CreateMessage(MessageType type, const std::string& payload = "") {
-    std::ostringstream oss;
-    oss << static_cast<int>(type);
-    if (!payload.empty()) {
-        oss << " " << payload;
-    }
-    return oss.str();
-}
+// Consecutive entries of the server's asset table, starting at firstID
+// Tables only grow, so each client is sent the entries added since its last update
+struct AssetTableUpdate {
+    uint32_t firstID = 1;
+    std::vector<std::string> paths;
+
+    // Serialization (binary only)
+    std::string Serialize() const;
+    static AssetTableUpdate Deserialize(const std::string& data);
+};
 
-// Helper to parse protocol messages
-inline bool ParseMessage(const std::string& message, MessageType& type, std::string& payload) {
-    std::istringstream iss(message);
-    int typeInt;
+// Last input command the server applied for a client before capturing a snapshot
+struct InputAck {
+    uint32_t sequence = 0;    // InputState::sequence of the command
+    uint32_t snapshotID = 0;  // Snapshot the command's result is in
 
-    if (!(iss >> typeInt)) {
-        return false;
-    }
+    // Serialization
+    std::string Serialize(WireFormat format = WireFormat::BINARY) const;
+    static InputAck Deserialize(const std::string& data, WireFormat format = WireFormat::BINARY);
+};
+
+// Serialization of a single ID payload (client IDs, despawned entity IDs)
+std::string SerializeID(uint32_t id, WireFormat format = WireFormat::BINARY);
+uint32_t DeserializeID(const std::string& data, WireFormat format = WireFormat::BINARY);
 
-    type = static_cast<MessageType>(typeInt);
+// Helper to create protocol messages
+std::string CreateMessage(MessageType type, const std::string& payload = "", WireFormat format = WireFormat::BINARY);
 
-    // Get the rest of the message as payload
-    if (iss.peek() == ' ') {
-        iss.ignore();
-    }
-    std::getline(iss, payload);
+// Helper to append a message to a buffer holding several messages
+// Binary messages are simply concatenated (the header carries the size), text messages are separated by newlines
+void AppendMessage(std::string& buffer, MessageType type, const std::string& payload, WireFormat format = WireFormat::BINARY);
 
-    return true;
-}
+// Helper to parse protocol messages (detects the wire format from the first byte)
+bool ParseMessage(const std::string& message, MessageType& type, std::string& payload);
+bool ParseMessage(const std::string& message, MessageType& type, std::string& payload, WireFormat& format);
+
+// Helper to read the next message from a buffer built with AppendMessage, advancing offset past it
+// Returns false at the end of the buffer or on a malformed message
+bool ReadMessage(const std::string& buffer, size_t& offset, MessageType& type, std::string& payload, WireFormat& format);
 
 }
 
@@ -0,0 +1,104 @@
+#include "PlayerPredictor.h"
+#include <iostream>
+
+namespace RiverCore {
+
+void PlayerPredictor::SetEntity(uint32_t entityID) {
+    if (entityID == predictedEntity) {
+        return;
+    }
+
+    Reset();
+    if (entityID == 0 || !entityManagerRef) {
+        return;
+    }
+
+    // Prediction integrates the body itself, so the local physics step must not move it as well
+    predictedEntity = entityID;
+    entityManagerRef->ModifyEntity(entityID, [this](Entity& entity) {
+        integrateBody = entity.physApplied;
+        entity.physApplied = false;
+    });
+}
+
+bool PlayerPredictor::IsActive() const {
+    return predictedEntity != 0 && !unsupported && entityManagerRef && physicsRef && inputHandler;
+}
+
+bool PlayerPredictor::Predict(const InputState& command, float deltaTime) {
+    if (!IsActive()) {
+        return false;
+    }
+
+    history.push_back({command, deltaTime});
+    while (history.size() > MAX_HISTORY) {
+        history.pop_front();
+    }
+
+    if (!Apply(history.back())) {
+        std::cout << "PlayerPredictor: Input handler does not handle input, leaving the player to the server\n";
+        unsupported = true;
+
+        // Hand the entity back to the local physics step
+        entityManagerRef->ModifyEntity(predictedEntity, [this](Entity& entity) {
+            entity.physApplied = integrateBody;
+        });
+        history.clear();
+        return false;
+    }
+    return true;
+}
+
+void PlayerPredictor::Reconcile(const EntitySnapshot& state, uint32_t ackedSequence) {
+    if (!IsActive()) {
+        return;
+    }
+
+    // Commands up to the acknowledged one are part of the server's state
+    while (!history.empty() && history.front().input.sequence <= ackedSequence) {
+        history.pop_front();
+    }
+
+    // The animation frame keeps running locally rather than jumping back to the server's
+    entityManagerRef->ModifyEntity(predictedEntity, [&state](Entity& entity) {
+        entity.position = state.position;
+        entity.velocity = state.velocity;
+        entity.acceleration = Vec2::zero();
+        entity.scale = state.scale;
+        entity.rotation = state.rotation;
+        entity.flipX = state.flipX;
+        entity.flipY = state.flipY;
+    });
+
+    for (const Command& command : history) {
+        Apply(command);
+    }
+}
+
+void PlayerPredictor::Reset() {
+    if (predictedEntity != 0 && entityManagerRef && !unsupported) {
+        entityManagerRef->ModifyEntity(predictedEntity, [this](Entity& entity) {
+            entity.physApplied = integrateBody;
+        });
+    }
+
+    predictedEntity = 0;
+    integrateBody = false;
+    unsupported = false;
+    history.clear();
+}
+
+bool PlayerPredictor::Apply(const Command& command) {
+    if (!inputHandler(predictedEntity, command.input, command.deltaTime)) {
+        return false;
+    }
+
+    if (integrateBody) {
+        entityManagerRef->ModifyEntity(predictedEntity, [this, &command](Entity& entity) {
+            physicsRef->IntegrateBody(entity, command.deltaTime);
+        });
+    }
+    return true;
+}
+
+}
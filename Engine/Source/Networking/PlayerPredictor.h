@@ -0,0 +1,70 @@
+#ifndef PLAYERPREDICTOR_H
+#define PLAYERPREDICTOR_H
+
+#include "NetworkProtocol.h"
+#include "Renderer/EntityManager.h"
+#include "Physics/Physics.h"
+#include <deque>
+#include <functional>
+
+namespace RiverCore {
+
+// Runs the local player's input commands on the client as soon as they are issued, instead of waiting for the
+// server's state to come back
+// Each command goes through the same input handler and body integration the server runs per tick, and is kept
+// until the server acknowledges it. When a snapshot acknowledging a command arrives, the player is reset to its
+// authoritative state and the commands the server has not applied yet are replayed on top of it.
+// Collisions are not predicted; the server's resolution shows up on the next reconciliation.
+class PlayerPredictor {
+public:
+    // Applies an input command to an entity over a time step, returning false if it does not handle input
+    using InputHandler = std::function<bool(uint32_t entityID, const InputState& input, float deltaTime)>;
+
+    // Set the references used to run commands (prediction is off until both are set)
+    void SetEntityManager(EntityManager* entityManager) { entityManagerRef = entityManager; }
+    void SetPhysics(const Physics* physics) { physicsRef = physics; }
+    void SetInputHandler(InputHandler handler) { inputHandler = std::move(handler); }
+
+    // Starts predicting a local entity, taking it out of the local physics step (0 stops predicting)
+    void SetEntity(uint32_t entityID);
+    // Get the predicted local entity (0 = none)
+    uint32_t GetEntity() const { return predictedEntity; }
+    // Returns if commands are being predicted
+    bool IsActive() const;
+
+    // Runs a new command on the predicted entity and keeps it for replay
+    // Stops predicting (returning false) if the input handler does not handle input
+    bool Predict(const InputState& command, float deltaTime);
+    // Resets the predicted entity to its server state after the acknowledged command, then replays the rest
+    void Reconcile(const EntitySnapshot& state, uint32_t ackedSequence);
+    // Stops predicting and forgets every command
+    void Reset();
+
+private:
+    EntityManager* entityManagerRef = nullptr;
+    const Physics* physicsRef = nullptr;
+    InputHandler inputHandler;
+
+    uint32_t predictedEntity = 0;
+    // Whether the entity was a physics body before prediction took it out of the local physics step
+    bool integrateBody = false;
+    // Set once the input handler turned out not to handle input
+    bool unsupported = false;
+
+    struct Command {
+        InputState input;
+        float deltaTime;
+    };
+    // Commands not acknowledged by the server yet, oldest first
+    std::deque<Command> history;
+
+    // Commands kept when the server stops acknowledging them
+    static constexpr size_t MAX_HISTORY = 256;
+
+    // Applies a command to the predicted entity
+    bool Apply(const Command& command);
+};
+
+}
+
+#endif
@@ -2,7 +2,8 @@
 #include "Core/GameInterface.h"
 #include <zmq/zmq.hpp>
 #include <iostream>
-#include <sstream>
+#include <algorithm>
+#include <iterator>
 #include <chrono>
 #include <thread>
 
@@ -10,7 +11,13 @@ namespace RiverCore {
 
 // Global ZMQ context
 static zmq::context_t context(1);
-static zmq::socket_t* acceptSocket = nullptr;
+// Router socket every client connects to, each client addressed by its routing ID
+static zmq::socket_t* serverSocket = nullptr;
+
+// Releases a shared packet's reference once ZMQ has finished sending it (called on a ZMQ I/O thread)
+static void ReleaseSharedPacket(void*, void* hint) {
+    delete static_cast<std::shared_ptr<const std::string>*>(hint);
+}
 
 Server::Server() {
 }
@@ -38,17 +45,19 @@ void Server::Start(GameInterface* gameLogic) {
     try {
         InitializeSockets();
 
-        // Start connection listener thread
-        std::thread listener(&Server::ConnectionListenerThread, this);
-        listener.detach();
+        // Start the thread servicing every client
+        networkThread = std::thread(&Server::NetworkThread, this);
 
         // Run simulation loop in main thread
         SimulationLoop();
 
     } catch (const std::exception& e) {
         std::cout << "Failed to start server: " << e.what() << "\n";
-        CleanupSockets();
         running = false;
+        if (networkThread.joinable()) {
+            networkThread.join();
+        }
+        CleanupSockets();
     }
 }
 
@@ -60,39 +69,42 @@ void Server::Stop() {
     std::cout << "Stopping server...\n";
     running = false;
 
-    // Signal all client threads to stop
-    {
-        std::lock_guard<std::mutex> lock(clientConnectionsMutex);
-        for (auto& conn : clientConnections) {
-            conn->active = false;
-        }
+    // Wait for the network thread to finish with the server socket
+    if (networkThread.joinable()) {
+        networkThread.join();
     }
 
-    // Give threads time to finish
-    std::this_thread::sleep_for(std::chrono::milliseconds(200));
-
-    // Join all client threads
     {
         std::lock_guard<std::mutex> lock(clientConnectionsMutex);
-        for (auto& conn : clientConnections) {
-            if (conn->thread.joinable()) {
-                conn->thread.join();
-            }
-        }
         clientConnections.clear();
     }
+    routedClients.clear();
+    assetTable.Clear();
 
     CleanupSockets();
     std::cout << "Server stopped successfully\n";
 }
 
+void Server::SetNetworkWorkerCount(size_t workerCount) {
+    workerCount = std::max<size_t>(workerCount, 1);
+    if (workerCount == GetNetworkWorkerCount()) {
+        return;
+    }
+
+    encodePool.reset();
+    if (workerCount > 1) {
+        encodePool = std::make_unique<WorkerPool>(workerCount);
+    }
+}
+
 void Server::InitializeSockets() {
     try {
-        acceptSocket = new zmq::socket_t(context, zmq::socket_type::rep);
-        acceptSocket->bind("tcp://*:5555");
-
-        int timeout = 100;
-        acceptSocket->set(zmq::sockopt::rcvtimeo, timeout);
+        serverSocket = new zmq::socket_t(context, zmq::socket_type::router);
+        serverSocket->set(zmq::sockopt::linger, 0);
+        // Report unroutable sends instead of dropping them, so vanished clients are noticed
+        serverSocket->set(zmq::sockopt::router_mandatory, true);
+        serverSocket->set(zmq::sockopt::sndhwm, CLIENT_SEND_QUEUE_LIMIT);
+        serverSocket->bind("tcp://*:" + std::to_string(SERVER_PORT));
 
     } catch (const zmq::error_t& e) {
         CleanupSockets();
@@ -101,113 +113,205 @@ void Server::InitializeSockets() {
 }
 
 void Server::CleanupSockets() {
-    if (acceptSocket) {
+    if (serverSocket) {
         try {
-            acceptSocket->close();
-            delete acceptSocket;
-            acceptSocket = nullptr;
+            serverSocket->close();
+            delete serverSocket;
+            serverSocket = nullptr;
         } catch (const std::exception& e) {
-            std::cout << "Error closing accept socket: " << e.what() << "\n";
+            std::cout << "Error closing server socket: " << e.what() << "\n";
         }
     }
 }
 
-void Server::ConnectionListenerThread() {
-    std::cout << "Connection listener started on port 5555\n";
+void Server::NetworkThread() {
+    std::cout << "Network thread started on port " << SERVER_PORT << "\n";
 
-    while (running.load()) {
+    // Subscribe to the simulation loop's tick notifications
+    zmq::socket_t tickSocket(context, zmq::socket_type::sub);
+    tickSocket.set(zmq::sockopt::linger, 0);
+    tickSocket.set(zmq::sockopt::subscribe, "");
+    tickSocket.connect(TICK_ENDPOINT);
+
+    while (running.load() && serverSocket) {
         try {
-            if (!acceptSocket) {
-                break;
+            // Sleep until a client sends something or a tick produces new state
+            zmq::pollitem_t items[] = {
+                { serverSocket->handle(), 0, ZMQ_POLLIN, 0 },
+                { tickSocket.handle(), 0, ZMQ_POLLIN, 0 }
+            };
+            zmq::poll(items, 2, std::chrono::milliseconds(100));
+
+            // Handle everything the clients streamed (connects, input and snapshot acks)
+            ReceiveClientMessages();
+
+            // Push the newest state once per batch of ticks (several ticks may have passed since the last wakeup)
+            bool ticked = false;
+            zmq::message_t tick;
+            while (tickSocket.recv(tick, zmq::recv_flags::dontwait)) {
+                ticked = true;
+            }
+            if (ticked) {
+                PushClientUpdates();
             }
 
-            // Listen for new connection requests
-            zmq::message_t request;
-            auto result = acceptSocket->recv(request, zmq::recv_flags::dontwait);
+        } catch (const zmq::error_t& e) {
+            if (e.num() != ETERM && running.load()) {
+                std::cout << "ZMQ error in network thread: " << e.what() << "\n";
+            }
+        } catch (const std::exception& e) {
+            std::cout << "Error in network thread: " << e.what() << "\n";
+        }
+    }
 
-            if (result) {
-                std::string requestStr(static_cast<char*>(request.data()), request.size());
+    std::cout << "Network thread stopped\n";
+}
 
-                MessageType msgType;
-                std::string payload;
-                if (!ParseMessage(requestStr, msgType, payload)) {
-                    std::cout << "Failed to parse message: " << requestStr << "\n";
-                    continue;
-                }
+void Server::ReceiveClientMessages() {
+    zmq::message_t identity;
+    while (serverSocket->recv(identity, zmq::recv_flags::dontwait)) {
+        // A router prefixes every message with the routing ID of the connection it came from
+        zmq::message_t frame;
+        if (!serverSocket->recv(frame, zmq::recv_flags::none)) {
+            break;
+        }
+        while (frame.more()) {
+            zmq::message_t extra;
+            (void)serverSocket->recv(extra, zmq::recv_flags::none);
+            frame.swap(extra);
+        }
 
-                if (msgType == MessageType::CONNECT) {
-                    // Handle new client connection
-                    uint32_t newClientID = HandleConnect(acceptSocket);
+        std::string routingID = identity.to_string();
+        std::string packet = frame.to_string();
+
+        auto routed = routedClients.find(routingID);
+        if (routed == routedClients.end()) {
+            // Only a binary connect request is accepted from an unknown connection
+            MessageType msgType;
+            std::string payload;
+            WireFormat format;
+            if (!ParseMessage(packet, msgType, payload, format)) {
+                std::cout << "Failed to parse message (" << packet.size() << " bytes)\n";
+            } else if (format != WireFormat::BINARY) {
+                std::cout << "Ignoring text protocol client (lockstep clients are no longer supported)\n";
+            } else if (msgType == MessageType::CONNECT) {
+                HandleConnect(routingID);
+            }
+            continue;
+        }
 
-                    std::ostringstream oss;
-                    oss << "CONNECTED " << newClientID;
-                    std::string response = oss.str();
+        ClientConnection* conn = routed->second;
+        if (!HandleClientMessages(*conn, packet)) {
+            HandleDisconnect(conn->clientID);
+            RemoveClient(conn);
+        }
+    }
+}
 
-                    zmq::message_t reply(response.size());
-                    memcpy(reply.data(), response.data(), response.size());
-                    acceptSocket->send(reply, zmq::send_flags::none);
+void Server::PushClientUpdates() {
+    GameStatePacket packet;
+    {
+        std::lock_guard<std::mutex> lock(stateQueueMutex);
+        if (!stateQueue.empty()) {
+            packet = stateQueue.back();
+        }
+    }
 
-                    std::cout << "Client " << newClientID << " connected\n";
-                }
+    pushClients.clear();
+    for (const auto& [routingID, conn] : routedClients) {
+        pushClients.push_back(conn);
+    }
+    pushUpdates.resize(pushClients.size());
+    pushSharedDelta.assign(pushClients.size(), -1);
+
+    // Without interest filtering or a bandwidth budget, clients that acknowledged the same snapshot are sent
+    // the same delta, so each distinct delta is encoded once and shared between them
+    sharedDeltas.clear();
+    if (packet.snapshot && !packet.interest && !bandwidthBudget.IsEnabled()) {
+        for (size_t i = 0; i < pushClients.size(); ++i) {
+            // Clients still being streamed the world are sent only part of the state
+            if (pushClients[i]->worldFrame) {
+                continue;
             }
 
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            std::shared_ptr<const GameStateSnapshot> baseline =
+                pushClients[i]->sentSnapshots.Find(pushClients[i]->ackedSnapshotID);
+            uint32_t baselineID = baseline ? baseline->snapshotID : 0;
 
-        } catch (const zmq::error_t& e) {
-            if (e.num() != ETERM && running.load()) {
-                std::cout << "ZMQ error in connection listener: " << e.what() << "\n";
+            auto shared = std::find_if(sharedDeltas.begin(), sharedDeltas.end(),
+                [baselineID](const SharedDelta& delta) { return delta.baselineID == baselineID; });
+            if (shared == sharedDeltas.end()) {
+                shared = sharedDeltas.insert(sharedDeltas.end(), SharedDelta{baselineID, std::move(baseline), nullptr});
             }
-        } catch (const std::exception& e) {
-            std::cout << "Error in connection listener: " << e.what() << "\n";
+            pushSharedDelta[i] = static_cast<int>(shared - sharedDeltas.begin());
         }
     }
 
-    std::cout << "Connection listener stopped\n";
-}
+    auto encodeShared = [this, &packet](size_t begin, size_t end, size_t) {
+        static const GameStateSnapshot emptyBaseline;
+        for (size_t i = begin; i < end; ++i) {
+            auto encoded = std::make_shared<std::string>();
+            AppendMessage(*encoded, MessageType::GAME_STATE_DELTA,
+                          SerializeSnapshotDelta(sharedDeltas[i].baseline ? *sharedDeltas[i].baseline : emptyBaseline,
+                                                 *packet.snapshot, snapshotQuantization));
+            sharedDeltas[i].encoded = std::move(encoded);
+        }
+    };
 
-uint32_t Server::HandleConnect(void* socket) {
-    uint32_t clientID = nextClientID.fetch_add(1);
+    // Encode every client's own part (each touches only its own connection, so they can run in parallel)
+    auto encodeClients = [this, &packet](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            pushUpdates[i].clear();
+            BuildClientUpdate(pushUpdates[i], *pushClients[i], packet, pushSharedDelta[i] >= 0);
+        }
+    };
+
+    if (encodePool) {
+        encodePool->ParallelFor(sharedDeltas.size(), 1, encodeShared);
+        encodePool->ParallelFor(pushClients.size(), 1, encodeClients);
+    } else {
+        encodeShared(0, sharedDeltas.size(), 0);
+        encodeClients(0, pushClients.size(), 0);
+    }
 
-    // Create dedicated socket for this client
-    zmq::socket_t* clientSocket = new zmq::socket_t(context, zmq::socket_type::rep);
-    std::string address = "tcp://*:" + std::to_string(5556 + clientID);
-    clientSocket->bind(address);
+    // Send from this thread, which owns the socket
+    for (size_t i = 0; i < pushClients.size(); ++i) {
+        const SharedPacket& shared = pushSharedDelta[i] >= 0 ? sharedDeltas[pushSharedDelta[i]].encoded : nullptr;
+        if (!SendToClient(*pushClients[i], pushUpdates[i], shared)) {
+            HandleDisconnect(pushClients[i]->clientID);
+            RemoveClient(pushClients[i]);
+        }
+    }
+}
 
-    int timeout = 100;
-    clientSocket->set(zmq::sockopt::rcvtimeo, timeout);
+ClientConnection* Server::HandleConnect(const std::string& routingID) {
+    uint32_t clientID = nextClientID.fetch_add(1);
 
-    // Create client connection (but don't start thread yet)
+    // Create client connection, addressed by the routing ID of the connection it came from
     auto conn = std::make_unique<ClientConnection>();
     conn->clientID = clientID;
     conn->active = true;
-    // NOTE: Thread not started yet to avoid race condition
+    conn->routingID = routingID;
+    ClientConnection* connPtr = conn.get();
 
     {
         std::lock_guard<std::mutex> lock(clientConnectionsMutex);
         clientConnections.push_back(std::move(conn));
     }
+    routedClients[routingID] = connPtr;
+
+    SendToClient(*connPtr, CreateMessage(MessageType::CONNECTED, SerializeID(clientID)));
 
-    // Send current world state to new client (queue all existing entities)
-    // This must happen BEFORE the client thread starts to avoid race condition
-    SendWorldStateToClient(clientID, clientSocket);
+    // Start streaming the current world, then notify game logic (spawn player and broadcast to all clients)
+    // Both reach the client from the next push from this thread on
+    BeginWorldTransfer(*connPtr);
 
-    // Notify game logic (spawn player and broadcast to all clients)
     if (gameLogic) {
         gameLogic->OnClientConnected(clientID);
     }
 
-    // NOW start the client thread (world state is already queued)
-    {
-        std::lock_guard<std::mutex> lock(clientConnectionsMutex);
-        for (auto& c : clientConnections) {
-            if (c->clientID == clientID) {
-                c->thread = std::thread(&Server::ClientThread, this, clientID, clientSocket);
-                break;
-            }
-        }
-    }
-
-    return clientID;
+    std::cout << "Client " << clientID << " connected\n";
+    return connPtr;
 }
 
 void Server::HandleDisconnect(uint32_t clientID) {
@@ -221,6 +325,7 @@ void Server::HandleDisconnect(uint32_t clientID) {
             clientPlayerMap.erase(it);
         }
     }
+    inputManager.RemoveClient(clientID);
 
     // Notify game logic
     if (gameLogic) {
@@ -230,103 +335,250 @@ void Server::HandleDisconnect(uint32_t clientID) {
     std::cout << "Client " << clientID << " disconnected\n";
 }
 
-void Server::ClientThread(uint32_t clientID, void* socketPtr) {
-    zmq::socket_t* clientSocket = static_cast<zmq::socket_t*>(socketPtr);
-    std::cout << "Client thread started for client " << clientID << "\n";
+void Server::RemoveClient(ClientConnection* conn) {
+    routedClients.erase(conn->routingID);
+
+    std::lock_guard<std::mutex> lock(clientConnectionsMutex);
+    auto it = std::find_if(clientConnections.begin(), clientConnections.end(),
+        [conn](const std::unique_ptr<ClientConnection>& c) { return c.get() == conn; });
+    if (it != clientConnections.end()) {
+        clientConnections.erase(it);
+    }
+}
+
+bool Server::SendToClient(const ClientConnection& conn, const std::string& packet, const SharedPacket& shared) {
+    try {
+        // Route the packet back to the client's connection
+        if (!serverSocket->send(zmq::buffer(conn.routingID), zmq::send_flags::sndmore | zmq::send_flags::dontwait)) {
+            std::cout << "Client " << conn.clientID << " is not keeping up, dropping it\n";
+            return false;
+        }
+
+        // The client reads each frame as its own packet
+        if (!shared || !packet.empty()) {
+            zmq::message_t message(packet.size());
+            memcpy(message.data(), packet.data(), packet.size());
+            serverSocket->send(message, shared ? zmq::send_flags::sndmore : zmq::send_flags::none);
+        }
 
-    // Find this client's connection
-    ClientConnection* conn = nullptr;
+        // The shared packet is referenced in place, holding a reference until ZMQ is done with it
+        if (shared) {
+            auto* reference = new SharedPacket(shared);
+            zmq::message_t message(const_cast<char*>(shared->data()), shared->size(), ReleaseSharedPacket, reference);
+            serverSocket->send(message, zmq::send_flags::none);
+        }
+        return true;
+    } catch (const zmq::error_t& e) {
+        if (e.num() != EHOSTUNREACH) {
+            throw;
+        }
+    }
+
+    // The client's connection is gone
+    std::cout << "Client " << conn.clientID << " is unreachable, dropping it\n";
+    return false;
+}
+
+bool Server::HandleClientMessages(ClientConnection& conn, const std::string& packet) {
+    // A packet may carry several messages (input plus snapshot ack)
+    MessageType msgType;
+    std::string payload;
+    WireFormat format = WireFormat::BINARY;
+    size_t offset = 0;
+    while (ReadMessage(packet, offset, msgType, payload, format)) {
+        if (format != WireFormat::BINARY) {
+            continue;
+        }
+
+        if (msgType == MessageType::INPUT) {
+            // Parse and queue input
+            InputState input = InputState::Deserialize(payload);
+            input.clientID = conn.clientID;
+            inputManager.QueueInput(input);
+        } else if (msgType == MessageType::SNAPSHOT_ACK) {
+            conn.ackedSnapshotID = DeserializeID(payload);
+        } else if (msgType == MessageType::DISCONNECT) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Server::BuildClientUpdate(std::string& response, ClientConnection& conn, const GameStatePacket& packet,
+                               bool sharedDelta) {
+    // Get and send queued spawn/despawn messages
     {
-        std::lock_guard<std::mutex> lock(clientConnectionsMutex);
-        for (auto& c : clientConnections) {
-            if (c->clientID == clientID) {
-                conn = c.get();
-                break;
+        std::lock_guard<std::mutex> queueLock(conn.queueMutex);
+
+        // Queued spawns had their sprites registered before being queued
+        AppendAssetTable(response, conn);
+
+        // Send spawn messages
+        for (const auto& spawnInfo : conn.spawnQueue) {
+            AppendMessage(response, MessageType::SPAWN_ENTITY, spawnInfo.Serialize());
+        }
+        conn.spawnQueue.clear();
+
+        // Send despawn messages
+        for (uint32_t entityID : conn.despawnQueue) {
+            AppendMessage(response, MessageType::DESPAWN_ENTITY, SerializeID(entityID));
+
+            // Never stream an entity that is already gone
+            if (conn.worldFrame) {
+                conn.worldDespawned.insert(entityID);
             }
         }
+        conn.despawnQueue.clear();
     }
 
-    while (running.load() && conn && conn->active.load()) {
-        try {
-            // Receive input from client
-            zmq::message_t request;
-            auto result = clientSocket->recv(request, zmq::recv_flags::dontwait);
-
-            if (result) {
-                std::string requestStr(static_cast<char*>(request.data()), request.size());
-
-                MessageType msgType;
-                std::string payload;
-                if (ParseMessage(requestStr, msgType, payload)) {
-                    if (msgType == MessageType::INPUT) {
-                        // Parse and queue input
-                        InputState input = InputState::Deserialize(payload);
-                        input.clientID = clientID;
-                        inputManager.QueueInput(input);
-                    } else if (msgType == MessageType::DISCONNECT) {
-                        HandleDisconnect(clientID);
-                        conn->active = false;
-                        break;
-                    }
-                }
+    // Send the next part of the world to a joining client
+    AppendWorldChunk(response, conn);
+
+    // Tell the client which of its input commands the state includes, ahead of the state itself
+    if (packet.snapshot && packet.processedInputs) {
+        auto it = packet.processedInputs->find(conn.clientID);
+        if (it != packet.processedInputs->end()) {
+            InputAck ack;
+            ack.sequence = it->second;
+            ack.snapshotID = packet.snapshot->snapshotID;
+            AppendMessage(response, MessageType::INPUT_ACK, ack.Serialize());
+        }
+    }
 
-                // Build response with queued messages and game state
-                std::ostringstream response;
+    // Send the tick's game state
+    AppendGameState(response, conn, packet, sharedDelta);
+}
 
-                // Get and send queued spawn/despawn messages
-                {
-                    std::lock_guard<std::mutex> queueLock(conn->queueMutex);
-
-                    // Send spawn messages
-                    for (const auto& spawnInfo : conn->spawnQueue) {
-                        response << CreateMessage(MessageType::SPAWN_ENTITY, spawnInfo.Serialize()) << "\n";
-                    }
-                    conn->spawnQueue.clear();
-
-                    // Send despawn messages
-                    for (uint32_t entityID : conn->despawnQueue) {
-                        response << CreateMessage(MessageType::DESPAWN_ENTITY, std::to_string(entityID)) << "\n";
-                    }
-                    conn->despawnQueue.clear();
-                }
+void Server::AppendSnapshotConfig(std::string& response, ClientConnection& conn) {
+    if (!conn.snapshotConfigSent) {
+        AppendMessage(response, MessageType::SNAPSHOT_CONFIG, snapshotQuantization.Serialize());
+        conn.snapshotConfigSent = true;
+    }
+}
 
-                // Send latest game state
-                GameStateSnapshot latestState;
-                {
-                    std::lock_guard<std::mutex> lock(stateQueueMutex);
-                    if (!stateQueue.empty()) {
-                        latestState = stateQueue.back().snapshot;
-                    }
-                }
+void Server::AppendAssetTable(std::string& response, ClientConnection& conn) {
+    if (conn.assetsSent == assetTable.GetCount()) {
+        return;
+    }
 
-                response << CreateMessage(MessageType::GAME_STATE, latestState.Serialize());
+    AssetTableUpdate update = assetTable.GetUpdate(conn.assetsSent);
+    conn.assetsSent += static_cast<uint32_t>(update.paths.size());
+    AppendMessage(response, MessageType::ASSET_TABLE, update.Serialize());
+}
 
-                std::string responseStr = response.str();
-                zmq::message_t reply(responseStr.size());
-                memcpy(reply.data(), responseStr.data(), responseStr.size());
-                clientSocket->send(reply, zmq::send_flags::none);
-            }
+void Server::AssignSpriteIDs(std::vector<EntitySpawnInfo>& spawns) {
+    // Neighbouring entities mostly share a sprite, so the table is only consulted when the path changes
+    const std::string* previousPath = nullptr;
+    uint32_t previousID = 0;
+    for (EntitySpawnInfo& spawnInfo : spawns) {
+        if (!previousPath || spawnInfo.spritePath != *previousPath) {
+            previousID = assetTable.Register(spawnInfo.spritePath);
+            previousPath = &spawnInfo.spritePath;
+        }
+        spawnInfo.spriteID = previousID;
+    }
+}
 
-            std::this_thread::sleep_for(std::chrono::milliseconds(16));
+void Server::AppendGameState(std::string& response, ClientConnection& conn, const GameStatePacket& packet,
+                             bool sharedDelta) {
+    if (!packet.snapshot) {
+        AppendMessage(response, MessageType::GAME_STATE, GameStateSnapshot().Serialize());
+        return;
+    }
 
-        } catch (const zmq::error_t& e) {
-            if (e.num() != ETERM && conn->active.load()) {
-                std::cout << "ZMQ error in client thread " << clientID << ": " << e.what() << "\n";
+    std::shared_ptr<const GameStateSnapshot> latestState = packet.snapshot;
+    if (packet.interest) {
+        latestState = FilterGameState(packet, conn, response);
+    } else if (conn.worldFrame) {
+        latestState = FilterStreamedState(*latestState, conn);
+    }
+
+    AppendSnapshotConfig(response, conn);
+
+    // Encode against the client's acknowledged snapshot, or send a keyframe (delta against nothing)
+    if (!sharedDelta) {
+        static const GameStateSnapshot emptyBaseline;
+        std::shared_ptr<const GameStateSnapshot> baseline = conn.sentSnapshots.Find(conn.ackedSnapshotID);
+        const GameStateSnapshot& baselineState = baseline ? *baseline : emptyBaseline;
+
+        // Leave out the entity updates that do not fit the client's budget this time
+        if (bandwidthBudget.IsEnabled()) {
+            uint32_t viewerEntityID = 0;
+            auto binding = latestState->playerEntityBindings.find(conn.clientID);
+            if (binding != latestState->playerEntityBindings.end()) {
+                viewerEntityID = binding->second;
             }
-        } catch (const std::exception& e) {
-            std::cout << "Error in client thread " << clientID << ": " << e.what() << "\n";
+            latestState = conn.updateScheduler.Schedule(*latestState, baselineState, viewerEntityID,
+                                                        bandwidthBudget, snapshotQuantization);
         }
+
+        AppendMessage(response, MessageType::GAME_STATE_DELTA,
+                      SerializeSnapshotDelta(baselineState, *latestState, snapshotQuantization));
     }
 
-    // Cleanup
-    try {
-        clientSocket->close();
-        delete clientSocket;
-    } catch (const std::exception& e) {
-        std::cout << "Error closing client socket: " << e.what() << "\n";
+    conn.sentSnapshots.Store(latestState);
+}
+
+std::shared_ptr<const GameStateSnapshot> Server::FilterGameState(const GameStatePacket& packet, ClientConnection& conn,
+                                                                 std::string& response) {
+    const GameStateSnapshot& snapshot = *packet.snapshot;
+    const InterestIndex& interest = *packet.interest;
+
+    // Collect the entities around the client's player entity
+    uint32_t viewerEntityID = 0;
+    auto binding = snapshot.playerEntityBindings.find(conn.clientID);
+    if (binding != snapshot.playerEntityBindings.end()) {
+        viewerEntityID = binding->second;
+    }
+    std::vector<uint32_t> relevant;
+    interest.Collect(viewerEntityID, conn.relevantEntities, relevant);
+
+    // Despawn entities that left the area and spawn the ones that entered it (both lists are sorted)
+    std::vector<uint32_t> left;
+    std::vector<uint32_t> entered;
+    std::set_difference(conn.relevantEntities.begin(), conn.relevantEntities.end(),
+                        relevant.begin(), relevant.end(), std::back_inserter(left));
+    std::set_difference(relevant.begin(), relevant.end(),
+                        conn.relevantEntities.begin(), conn.relevantEntities.end(), std::back_inserter(entered));
+
+    for (uint32_t entityID : left) {
+        AppendMessage(response, MessageType::DESPAWN_ENTITY, SerializeID(entityID));
+    }
+    std::vector<EntitySpawnInfo> spawns;
+    spawns.reserve(entered.size());
+    for (uint32_t entityID : entered) {
+        EntitySpawnInfo spawnInfo = MakeSpawnInfo(interest.GetFrame(), static_cast<size_t>(interest.FindIndex(entityID)));
+        for (const auto& [clientID, playerEntityID] : snapshot.playerEntityBindings) {
+            if (playerEntityID == entityID) {
+                spawnInfo.ownerClientID = clientID;
+            }
+        }
+        spawns.push_back(std::move(spawnInfo));
+    }
+    AssignSpriteIDs(spawns);
+    AppendAssetTable(response, conn);
+    for (const EntitySpawnInfo& spawnInfo : spawns) {
+        AppendMessage(response, MessageType::SPAWN_ENTITY, spawnInfo.Serialize());
+    }
+    conn.relevantEntities.swap(relevant);
+
+    // Keep only the relevant entities of the tick's snapshot, searching the ID-sorted entities instead of
+    // walking all of them
+    auto filtered = std::make_shared<GameStateSnapshot>();
+    filtered->timestamp = snapshot.timestamp;
+    filtered->snapshotID = snapshot.snapshotID;
+    filtered->playerEntityBindings = snapshot.playerEntityBindings;
+    filtered->entities.reserve(conn.relevantEntities.size());
+    auto next = snapshot.entities.begin();
+    for (uint32_t entityID : conn.relevantEntities) {
+        next = std::lower_bound(next, snapshot.entities.end(), entityID,
+                                [](const EntitySnapshot& entity, uint32_t id) { return entity.entityID < id; });
+        if (next != snapshot.entities.end() && next->entityID == entityID) {
+            filtered->entities.push_back(*next);
+        }
     }
 
-    std::cout << "Client thread stopped for client " << clientID << "\n";
+    return filtered;
 }
 
 void Server::SimulationLoop() {
@@ -335,9 +587,19 @@ void Server::SimulationLoop() {
     auto lastTime = std::chrono::high_resolution_clock::now();
     float accumulator = 0.0f;
 
+    // Snapshots are stamped with their tick's scheduled time, so ticks run back to back to catch up are still
+    // spaced one timestep apart for client interpolation
+    auto startTime = lastTime;
+    uint64_t tickCount = 0;
+
     // Connect event manager to timeline for timestamp tracking
     serverEventManager.SetTimeline(&serverTimeline);
 
+    // The network thread wakes on this socket to push each tick's state
+    zmq::socket_t tickPublisher(context, zmq::socket_type::pub);
+    tickPublisher.set(zmq::sockopt::linger, 0);
+    tickPublisher.bind(TICK_ENDPOINT);
+
     while (running.load()) {
         auto currentTime = std::chrono::high_resolution_clock::now();
         float deltaTime = std::chrono::duration<float>(currentTime - lastTime).count();
@@ -347,17 +609,35 @@ void Server::SimulationLoop() {
 
         // Fixed timestep updates
         while (accumulator >= FIXED_TIMESTEP) {
+            auto tickStart = std::chrono::high_resolution_clock::now();
+
             // Apply timeline scaling
             float effectiveTimestep = serverTimeline.CalculateEffectiveTime(FIXED_TIMESTEP);
 
             // Update timeline
             serverTimeline.Update(FIXED_TIMESTEP);
 
+            // Apply each client's next input command to its player
+            inputManager.AdvanceInputs();
+            if (gameLogic) {
+                std::unordered_map<uint32_t, uint32_t> players;
+                {
+                    std::lock_guard<std::mutex> lock(clientPlayerMutex);
+                    players = clientPlayerMap;
+                }
+                for (const auto& [clientID, entityID] : players) {
+                    gameLogic->OnPlayerInput(entityID, inputManager.GetInputForClient(clientID), effectiveTimestep);
+                }
+            }
+
             // Update physics
-            serverEntityManager.UpdatePhysics([this, effectiveTimestep](std::vector<Entity>& entities) {
-                serverPhysics.UpdatePhysics(entities, effectiveTimestep);
+            serverEntityManager.UpdatePhysics([this, effectiveTimestep](EntityStorage& storage) {
+                serverPhysics.UpdatePhysics(storage, effectiveTimestep);
             });
 
+            // Queue this step's collision events for game logic
+            serverPhysics.FlushContactEvents(serverEventManager);
+
             // Update animations
             serverEntityManager.UpdateAnimations(effectiveTimestep);
 
@@ -366,16 +646,25 @@ void Server::SimulationLoop() {
                 gameLogic->OnUpdate(effectiveTimestep);
             }
 
+            // Publish this tick's frame state for the renderer and replication
+            std::shared_ptr<const FrameState> frame = serverEntityManager.PublishFrameState();
+
             // Capture game state
-            GameStateSnapshot snapshot = CaptureGameState();
-            snapshot.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-                currentTime.time_since_epoch()).count();
+            auto snapshot = std::make_shared<GameStateSnapshot>(CaptureGameState(*frame));
+            snapshot->timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+                startTime.time_since_epoch() + std::chrono::duration<double>(++tickCount * FIXED_TIMESTEP)).count();
+            snapshot->snapshotID = ++lastSnapshotID;
 
             // Push to state queue
             {
                 std::lock_guard<std::mutex> lock(stateQueueMutex);
                 GameStatePacket packet;
-                packet.snapshot = snapshot;
+                packet.snapshot = std::move(snapshot);
+                if (interestArea.IsEnabled()) {
+                    packet.interest = std::make_shared<InterestIndex>(frame, interestArea);
+                }
+                packet.processedInputs = std::make_shared<std::unordered_map<uint32_t, uint32_t>>(
+                    inputManager.GetProcessedInputs());
                 packet.timestamp = currentTime;
                 stateQueue.push(packet);
 
@@ -385,36 +674,52 @@ void Server::SimulationLoop() {
                 }
             }
 
+            // Wake the network thread to push the new state
+            tickPublisher.send(zmq::buffer(SerializeID(lastSnapshotID)), zmq::send_flags::dontwait);
+
+            // Record how long the tick took
+            {
+                std::lock_guard<std::mutex> lock(tickDurationsMutex);
+                tickDurations.push_back(std::chrono::duration<float>(
+                    std::chrono::high_resolution_clock::now() - tickStart).count());
+                if (tickDurations.size() > MAX_TICK_DURATIONS) {
+                    tickDurations.erase(tickDurations.begin());
+                }
+            }
+
             accumulator -= FIXED_TIMESTEP;
         }
 
-        // Sleep to maintain ~60Hz
-        std::this_thread::sleep_for(std::chrono::milliseconds(16));
+        // Sleep until the next tick is due
+        std::this_thread::sleep_for(std::chrono::duration<float>(FIXED_TIMESTEP - accumulator));
     }
 
     std::cout << "Server simulation loop stopped\n";
 }
 
-GameStateSnapshot Server::CaptureGameState() {
+GameStateSnapshot Server::CaptureGameState(const FrameState& frame) {
     GameStateSnapshot snapshot;
 
-    // Get all entities from server's entity manager
-    std::vector<Entity> entities = serverEntityManager.GetEntitiesCopy();
-
-    for (const Entity& entity : entities) {
+    // Read the tick's published frame state of the server's entity manager
+    snapshot.entities.reserve(frame.Size());
+    for (size_t i = 0; i < frame.Size(); ++i) {
         EntitySnapshot entitySnap;
-        entitySnap.entityID = entity.ID;
-        entitySnap.position = entity.position;
-        entitySnap.velocity = entity.velocity;
-        entitySnap.scale = entity.scale;
-        entitySnap.rotation = entity.rotation;
-        entitySnap.flipX = entity.flipX;
-        entitySnap.flipY = entity.flipY;
-        entitySnap.currentFrame = entity.currentFrame;
+        entitySnap.entityID = frame.ids[i];
+        entitySnap.position = frame.transform.position[i];
+        entitySnap.velocity = frame.velocity[i];
+        entitySnap.scale = frame.transform.scale[i];
+        entitySnap.rotation = frame.transform.rotation[i];
+        entitySnap.flipX = frame.transform.flipX[i] != 0;
+        entitySnap.flipY = frame.transform.flipY[i] != 0;
+        entitySnap.currentFrame = frame.animation.currentFrame[i];
 
         snapshot.entities.push_back(entitySnap);
     }
 
+    // Order by ID so snapshots can be diffed with a single merge walk
+    std::sort(snapshot.entities.begin(), snapshot.entities.end(),
+              [](const EntitySnapshot& a, const EntitySnapshot& b) { return a.entityID < b.entityID; });
+
     // Add player bindings
     {
         std::lock_guard<std::mutex> lock(clientPlayerMutex);
@@ -439,6 +744,13 @@ void Server::UnregisterPlayerEntity(uint32_t clientID) {
     }
 }
 
+std::vector<float> Server::GetTickDurations() {
+    std::lock_guard<std::mutex> lock(tickDurationsMutex);
+    std::vector<float> durations = std::move(tickDurations);
+    tickDurations.clear();
+    return durations;
+}
+
 std::vector<uint32_t> Server::GetConnectedClients() const {
     std::lock_guard<std::mutex> lock(clientConnectionsMutex);
     std::vector<uint32_t> clients;
@@ -460,11 +772,17 @@ uint32_t Server::GetPlayerEntityForClient(uint32_t clientID) const {
 }
 
 void Server::BroadcastEntitySpawn(const EntitySpawnInfo& spawnInfo, uint32_t ownerClientID, uint32_t excludeClientID) {
+    // With interest filtering spawns are sent when the entity enters each client's area
+    if (interestArea.IsEnabled()) {
+        return;
+    }
+
     std::lock_guard<std::mutex> lock(clientConnectionsMutex);
 
-    // Create a copy with owner set
+    // Create a copy with owner and sprite ID set
     EntitySpawnInfo spawnInfoWithOwner = spawnInfo;
     spawnInfoWithOwner.ownerClientID = ownerClientID;
+    spawnInfoWithOwner.spriteID = assetTable.Register(spawnInfo.spritePath);
 
     for (auto& conn : clientConnections) {
         if (conn->active.load() && conn->clientID != excludeClientID) {
@@ -478,6 +796,11 @@ void Server::BroadcastEntitySpawn(const EntitySpawnInfo& spawnInfo, uint32_t own
 }
 
 void Server::BroadcastEntityDespawn(uint32_t entityID, uint32_t excludeClientID) {
+    // With interest filtering despawns are sent when the entity leaves each client's area (or the world)
+    if (interestArea.IsEnabled()) {
+        return;
+    }
+
     std::lock_guard<std::mutex> lock(clientConnectionsMutex);
 
     for (auto& conn : clientConnections) {
@@ -491,36 +814,112 @@ void Server::BroadcastEntityDespawn(uint32_t entityID, uint32_t excludeClientID)
               << clientConnections.size() << " clients\n";
 }
 
-void Server::SendWorldStateToClient(uint32_t clientID, void* clientSocket) {
-    // Get all entities from entity manager
-    std::vector<Entity> entities = serverEntityManager.GetEntitiesCopy();
+EntitySpawnInfo Server::MakeSpawnInfo(const FrameState& frame, size_t index) {
+    EntitySpawnInfo spawnInfo;
+    spawnInfo.entityID = frame.ids[index];
+    spawnInfo.spritePath = frame.render.spritePath[index];
+    spawnInfo.totalFrames = frame.animation.totalFrames[index];
+    spawnInfo.fps = frame.animation.fps[index];
+    spawnInfo.position = frame.transform.position[index];
+    spawnInfo.scale = frame.transform.scale[index];
+    spawnInfo.rotation = frame.transform.rotation[index];
+    spawnInfo.physEnabled = frame.physApplied[index] != 0;
+    spawnInfo.colliderType = static_cast<int>(frame.colliderType[index]);
+    return spawnInfo;
+}
 
-    std::cout << "Sending world state to client " << clientID
-              << " (" << entities.size() << " entities)\n";
+void Server::BeginWorldTransfer(ClientConnection& conn) {
+    // With interest filtering the client is sent the entities around its player as they become relevant
+    if (interestArea.IsEnabled()) {
+        return;
+    }
 
-    // For each entity, create a spawn message and queue it
-    for (const Entity& entity : entities) {
-        EntitySpawnInfo spawnInfo;
-        spawnInfo.entityID = entity.ID;
-        spawnInfo.spritePath = entity.spritePath;
-        spawnInfo.totalFrames = entity.totalFrames;
-        spawnInfo.fps = entity.fps;
-        spawnInfo.position = entity.position;
-        spawnInfo.scale = entity.scale;
-        spawnInfo.rotation = entity.rotation;
-        spawnInfo.physEnabled = entity.physApplied;
-        spawnInfo.colliderType = static_cast<int>(entity.collider.type);
+    // Publish a fresh frame so entities spawned since the last tick are included; the frame is immutable, so
+    // the world is streamed from it without holding any lock
+    conn.worldFrame = serverEntityManager.PublishFrameState();
+    conn.worldSent = 0;
+    conn.worldDespawned.clear();
+
+    // Stream in ID order, which keeps the chunks' ID gaps small
+    const FrameState& frame = *conn.worldFrame;
+    conn.worldOrder.resize(frame.Size());
+    for (size_t i = 0; i < frame.Size(); ++i) {
+        conn.worldOrder[i] = static_cast<uint32_t>(i);
+    }
+    std::sort(conn.worldOrder.begin(), conn.worldOrder.end(),
+              [&frame](uint32_t a, uint32_t b) { return frame.ids[a] < frame.ids[b]; });
 
-        // Queue this spawn for the client
-        std::lock_guard<std::mutex> lock(clientConnectionsMutex);
-        for (auto& conn : clientConnections) {
-            if (conn->clientID == clientID) {
-                std::lock_guard<std::mutex> queueLock(conn->queueMutex);
-                conn->spawnQueue.push_back(spawnInfo);
-                break;
-            }
+    conn.worldOwners.clear();
+    {
+        std::lock_guard<std::mutex> lock(clientPlayerMutex);
+        for (const auto& [clientID, entityID] : clientPlayerMap) {
+            conn.worldOwners[entityID] = clientID;
+        }
+    }
+
+    std::cout << "Streaming world state to client " << conn.clientID
+              << " (" << frame.Size() << " entities)\n";
+}
+
+void Server::AppendWorldChunk(std::string& response, ClientConnection& conn) {
+    if (!conn.worldFrame) {
+        return;
+    }
+
+    const FrameState& frame = *conn.worldFrame;
+    std::vector<EntitySpawnInfo> spawns;
+    spawns.reserve(std::min(WORLD_CHUNK_ENTITIES, conn.worldOrder.size() - conn.worldSent));
+    while (conn.worldSent < conn.worldOrder.size() && spawns.size() < WORLD_CHUNK_ENTITIES) {
+        size_t index = conn.worldOrder[conn.worldSent++];
+        if (conn.worldDespawned.count(frame.ids[index]) > 0) {
+            continue;
         }
+        spawns.push_back(MakeSpawnInfo(frame, index));
+        auto owner = conn.worldOwners.find(spawns.back().entityID);
+        if (owner != conn.worldOwners.end()) {
+            spawns.back().ownerClientID = owner->second;
+        }
+    }
+
+    if (!spawns.empty()) {
+        AssignSpriteIDs(spawns);
+        AppendAssetTable(response, conn);
+        AppendSnapshotConfig(response, conn);
+        AppendMessage(response, MessageType::WORLD_CHUNK, SerializeSpawnChunk(spawns, snapshotQuantization));
     }
+
+    // Release the frame once the whole world was sent
+    if (conn.worldSent == conn.worldOrder.size()) {
+        std::cout << "Streamed world state to client " << conn.clientID << "\n";
+        conn.worldFrame.reset();
+        conn.worldOrder = std::vector<uint32_t>();
+        conn.worldOwners.clear();
+        conn.worldDespawned.clear();
+    }
+}
+
+
+std::shared_ptr<const GameStateSnapshot> Server::FilterStreamedState(const GameStateSnapshot& snapshot,
+                                                                     const ClientConnection& conn) {
+    const FrameState& frame = *conn.worldFrame;
+    auto filtered = std::make_shared<GameStateSnapshot>();
+    filtered->timestamp = snapshot.timestamp;
+    filtered->snapshotID = snapshot.snapshotID;
+    filtered->playerEntityBindings = snapshot.playerEntityBindings;
+    filtered->entities.reserve(snapshot.entities.size());
+
+    // Walk the ID-sorted snapshot and world order together; entities missing from the world frame were
+    // spawned since and reach the client through its spawn queue
+    size_t w = 0;
+    for (const EntitySnapshot& entity : snapshot.entities) {
+        while (w < conn.worldOrder.size() && frame.ids[conn.worldOrder[w]] < entity.entityID) ++w;
+        bool inWorld = w < conn.worldOrder.size() && frame.ids[conn.worldOrder[w]] == entity.entityID;
+        if (!inWorld || w < conn.worldSent) {
+            filtered->entities.push_back(entity);
+        }
+    }
+
+    return filtered;
 }
 
 }
@@ -3,11 +3,17 @@
 
 #include "ServerInputManager.h"
 #include "NetworkProtocol.h"
+#include "SnapshotDelta.h"
+#include "InterestIndex.h"
+#include "UpdateScheduler.h"
+#include "AssetTable.h"
 #include "Renderer/EntityManager.h"
 #include "Physics/Physics.h"
 #include "Core/Timeline.h"
 #include "EventHandler/EventManager.h"
+#include "Core/WorkerPool.h"
 #include <unordered_map>
+#include <unordered_set>
 #include <string>
 #include <chrono>
 #include <mutex>
@@ -23,13 +29,34 @@ class GameInterface;
 // Client connection data
 struct ClientConnection {
     uint32_t clientID;
-    std::thread thread;
     std::atomic<bool> active{true};
 
     // Message queues for entity spawn/despawn
     std::vector<EntitySpawnInfo> spawnQueue;
     std::vector<uint32_t> despawnQueue;
     std::mutex queueMutex;
+
+    // Delta baselines (only touched by the network thread)
+    SnapshotHistory sentSnapshots;      // Snapshots sent to the client, by snapshot ID
+    uint32_t ackedSnapshotID = 0;       // Latest snapshot the client reported holding
+    bool snapshotConfigSent = false;    // Whether the client has received the snapshot quantization
+    uint32_t assetsSent = 0;            // Asset table entries the client has received
+
+    // Entities spawned on the client by interest filtering, sorted by ID (only touched by the network thread)
+    std::vector<uint32_t> relevantEntities;
+
+    // Chooses the entity updates sent within the bandwidth budget (only touched by the network thread)
+    UpdateScheduler updateScheduler;
+
+    // World streamed to the joining client a chunk per update (only touched by the network thread)
+    std::shared_ptr<const FrameState> worldFrame;       // Frame the world is sent from, null once it was sent
+    std::vector<uint32_t> worldOrder;                   // Dense indices of the frame's entities, sorted by ID
+    size_t worldSent = 0;                               // Entries of worldOrder already sent
+    std::unordered_map<uint32_t, uint32_t> worldOwners; // Player entity ID -> owning client ID
+    std::unordered_set<uint32_t> worldDespawned;        // Entities despawned before their turn came
+
+    // Transport state (only touched by the network thread)
+    std::string routingID;              // Identity of the client's connection on the server socket
 };
 
 class Server {
@@ -53,11 +80,42 @@ public:
     // Get server's event manager (for game logic access)
     EventManager& GetEventManager() { return serverEventManager; }
 
+    // Set the quantization of replicated entity fields (call before Start; clients receive it on connect)
+    void SetSnapshotQuantization(const SnapshotQuantization& quantization) { snapshotQuantization = quantization; }
+    // Get the quantization of replicated entity fields
+    const SnapshotQuantization& GetSnapshotQuantization() const { return snapshotQuantization; }
+
+    // Set the area of interest around each client's player entity (call before Start)
+    // When enabled, clients only receive entities inside their area, and spawns/despawns are sent as entities
+    // enter and leave it instead of through BroadcastEntitySpawn/BroadcastEntityDespawn
+    void SetInterestArea(const InterestArea& area) { interestArea = area; }
+    // Get the area of interest around each client's player entity
+    const InterestArea& GetInterestArea() const { return interestArea; }
+
+    // Set the per-client limit on entity update bytes (call before Start)
+    // When enabled, each snapshot sends the changed entities that fit the client's budget in priority order,
+    // and each client's delta is encoded separately instead of being shared
+    void SetBandwidthBudget(const BandwidthBudget& budget) { bandwidthBudget = budget; }
+    // Get the per-client limit on entity update bytes
+    const BandwidthBudget& GetBandwidthBudget() const { return bandwidthBudget; }
+
+    // Set the number of threads each tick's client updates are encoded across (call before Start)
+    // All sockets are still serviced by the single network thread
+    void SetNetworkWorkerCount(size_t workerCount);
+    // Get the number of threads each tick's client updates are encoded across
+    size_t GetNetworkWorkerCount() const { return encodePool ? encodePool->GetWorkerCount() : 1; }
+
     // Mark an entity as controlled by a client
     void RegisterPlayerEntity(uint32_t clientID, uint32_t entityID);
     // Unregister a player entity
     void UnregisterPlayerEntity(uint32_t clientID);
 
+    // Get and clear the durations of the simulation ticks run since the last call, in seconds (thread-safe)
+    // Ticks taking longer than the fixed timestep make the simulation fall behind real time
+    std::vector<float> GetTickDurations();
+    // Get the fixed simulation timestep, in seconds
+    static constexpr float GetFixedTimestep() { return FIXED_TIMESTEP; }
+
     // Get connected client IDs
     std::vector<uint32_t> GetConnectedClients() const;
     // Get player entity ID for a client
@@ -83,6 +141,27 @@ private:
     std::vector<std::unique_ptr<ClientConnection>> clientConnections;
     mutable std::mutex clientConnectionsMutex;
 
+    // Connections by routing ID on the server socket (network thread only)
+    std::unordered_map<std::string, ClientConnection*> routedClients;
+    // A tick's game state encoded once and sent to several clients without copying it
+    using SharedPacket = std::shared_ptr<const std::string>;
+    struct SharedDelta {
+        uint32_t baselineID = 0;
+        std::shared_ptr<const GameStateSnapshot> baseline;  // Null for keyframes
+        SharedPacket encoded;
+    };
+
+    // Reused per-tick buffers (network thread only)
+    std::vector<ClientConnection*> pushClients;     // Clients being pushed to
+    std::vector<std::string> pushUpdates;           // Each client's own part of its update
+    std::vector<int> pushSharedDelta;               // Index into sharedDeltas of each client's state, or -1
+    std::vector<SharedDelta> sharedDeltas;          // The tick's distinct deltas, by baseline
+
+    // Thread servicing the server socket for every client
+    std::thread networkThread;
+    // Optional workers for encoding client updates (null encodes on the network thread)
+    std::unique_ptr<WorkerPool> encodePool;
+
     // Next available client ID
     std::atomic<uint32_t> nextClientID{1};
 
@@ -91,36 +170,99 @@ private:
 
     // Game state queue for sending to clients
     struct GameStatePacket {
-        GameStateSnapshot snapshot;
+        std::shared_ptr<const GameStateSnapshot> snapshot;
+        std::shared_ptr<const InterestIndex> interest;  // Null when interest filtering is disabled
+        std::shared_ptr<const std::unordered_map<uint32_t, uint32_t>> processedInputs;  // clientID -> last applied input
         std::chrono::time_point<std::chrono::high_resolution_clock> timestamp;
     };
     std::queue<GameStatePacket> stateQueue;
     mutable std::mutex stateQueueMutex;
 
+    // Quantization of entity fields in delta-encoded states
+    SnapshotQuantization snapshotQuantization;
+    // Area of interest used to filter each client's entities
+    InterestArea interestArea;
+    // IDs of the sprite paths referenced by spawn messages
+    AssetTable assetTable;
+    // Limit on the entity update bytes sent to each client
+    BandwidthBudget bandwidthBudget;
+
+    // Durations of the ticks run since the last GetTickDurations call, in seconds
+    std::vector<float> tickDurations;
+    std::mutex tickDurationsMutex;
+    // Tick durations kept when nobody collects them
+    static constexpr size_t MAX_TICK_DURATIONS = 3600;
+
+    // ID of the last captured snapshot (simulation thread only)
+    uint32_t lastSnapshotID = 0;
+
+    // Port of the server socket all clients connect to
+    static constexpr int SERVER_PORT = 5555;
+    // In-process endpoint the simulation loop notifies the network thread on after each tick
+    static constexpr const char* TICK_ENDPOINT = "inproc://river-server-ticks";
+    // Packets queued for a client before it is considered too far behind (about 16 seconds of ticks)
+    static constexpr int CLIENT_SEND_QUEUE_LIMIT = 1000;
+    // Spawn records streamed to a joining client per update (a few kilobytes)
+    static constexpr size_t WORLD_CHUNK_ENTITIES = 512;
+
     // Main simulation loop (runs game logic at 60Hz)
     void SimulationLoop();
 
-    // Per-client thread function
-    void ClientThread(uint32_t clientID, void* socket);
+    // Network thread function: services the server socket and pushes each tick's state to every client
+    void NetworkThread();
+    // Handle every message queued on the server socket
+    void ReceiveClientMessages();
+    // Encode the latest state for every client and send it
+    void PushClientUpdates();
 
-    // Handle client connection
-    uint32_t HandleConnect(void* socket);
+    // Handle client connection from a routing ID
+    ClientConnection* HandleConnect(const std::string& routingID);
     // Handle client disconnection
     void HandleDisconnect(uint32_t clientID);
+    // Forget a disconnected client's connection
+    void RemoveClient(ClientConnection* conn);
 
-    // Serialize current game state
-    GameStateSnapshot CaptureGameState();
+    // Serialize a published frame's game state (entities sorted by ID, as the delta encoder expects)
+    GameStateSnapshot CaptureGameState(const FrameState& frame);
+    // Narrow a tick's snapshot to a client's area of interest, queueing spawns and despawns for entities
+    // that entered or left it
+    std::shared_ptr<const GameStateSnapshot> FilterGameState(const GameStatePacket& packet, ClientConnection& conn,
+                                                             std::string& response);
+    // Build the spawn message for the entity at a dense frame index
+    static EntitySpawnInfo MakeSpawnInfo(const FrameState& frame, size_t index);
+    // Encode a tick's game state for a client, as a delta against its acknowledged snapshot when possible
+    // If the delta is sent from the tick's shared encodings, only records it as sent
+    void AppendGameState(std::string& response, ClientConnection& conn, const GameStatePacket& packet,
+                         bool sharedDelta);
+    // Encode the client's queued spawns/despawns followed by a tick's game state
+    void BuildClientUpdate(std::string& response, ClientConnection& conn, const GameStatePacket& packet,
+                           bool sharedDelta);
+    // Handle the messages of one packet from a client, returns false if the client disconnected
+    bool HandleClientMessages(ClientConnection& conn, const std::string& packet);
+    // Send a packet to a client over the server socket, followed by a shared packet (if any) referenced without
+    // copying it; returns false if the client is gone or too far behind
+    static bool SendToClient(const ClientConnection& conn, const std::string& packet,
+                             const SharedPacket& shared = nullptr);
 
-    // Send world state to newly connected client
-    void SendWorldStateToClient(uint32_t clientID, void* clientSocket);
+    // Start streaming the world to a newly connected client
+    void BeginWorldTransfer(ClientConnection& conn);
+    // Encode the client's next chunk of the world, if it is still being streamed
+    void AppendWorldChunk(std::string& response, ClientConnection& conn);
+    // Narrow a tick's snapshot to the entities a joining client was sent so far, leaving out the world
+    // entities it has not been streamed yet
+    static std::shared_ptr<const GameStateSnapshot> FilterStreamedState(const GameStateSnapshot& snapshot,
+                                                                        const ClientConnection& conn);
+    // Encode the snapshot quantization if the client has not received it yet
+    void AppendSnapshotConfig(std::string& response, ClientConnection& conn);
+    // Encode the asset table entries the client has not received yet
+    void AppendAssetTable(std::string& response, ClientConnection& conn);
+    // Set the asset IDs of spawn messages' sprite paths
+    void AssignSpriteIDs(std::vector<EntitySpawnInfo>& spawns);
 
     // Socket management
     void InitializeSockets();
     void CleanupSockets();
 
-    // Connection listener thread
-    void ConnectionListenerThread();
-
     // Fixed timestep for simulation
     static constexpr float FIXED_TIMESTEP = 1.0f / 60.0f;
 };
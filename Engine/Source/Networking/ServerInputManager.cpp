@@ -4,7 +4,40 @@ namespace RiverCore {
 
 void ServerInputManager::QueueInput(const InputState& input) {
     std::lock_guard<std::mutex> lock(inputMutex);
-    currentInputs[input.clientID] = input;
+    ClientInputs& inputs = currentInputs[input.clientID];
+
+    if (input.sequence == 0) {
+        inputs.current = input;
+        return;
+    }
+
+    // Each command is sent once, but the latest one is repeated as a keepalive, so only take ones newer than any seen
+    if (input.sequence <= inputs.lastQueued) {
+        return;
+    }
+
+    if (inputs.queuedCount == MAX_QUEUED_INPUTS) {
+        inputs.queuedStart = (inputs.queuedStart + 1) % MAX_QUEUED_INPUTS;
+        --inputs.queuedCount;
+    }
+    inputs.queued[(inputs.queuedStart + inputs.queuedCount) % MAX_QUEUED_INPUTS] = input;
+    ++inputs.queuedCount;
+    inputs.lastQueued = input.sequence;
+}
+
+void ServerInputManager::AdvanceInputs() {
+    std::lock_guard<std::mutex> lock(inputMutex);
+
+    for (auto& [clientID, inputs] : currentInputs) {
+        if (inputs.queuedCount == 0) {
+            continue;
+        }
+
+        inputs.current = inputs.queued[inputs.queuedStart];
+        inputs.queuedStart = (inputs.queuedStart + 1) % MAX_QUEUED_INPUTS;
+        --inputs.queuedCount;
+        inputs.processed = inputs.current.sequence;
+    }
 }
 
 InputState ServerInputManager::GetInputForClient(uint32_t clientID) const {
@@ -12,7 +45,7 @@ InputState ServerInputManager::GetInputForClient(uint32_t clientID) const {
 
     auto it = currentInputs.find(clientID);
     if (it != currentInputs.end()) {
-        return it->second;
+        return it->second.current;
     }
 
     // Return empty input if client hasn't sent any
@@ -26,6 +59,30 @@ bool ServerInputManager::HasInputForClient(uint32_t clientID) const {
     return currentInputs.find(clientID) != currentInputs.end();
 }
 
+uint32_t ServerInputManager::GetLastProcessedInput(uint32_t clientID) const {
+    std::lock_guard<std::mutex> lock(inputMutex);
+
+    auto it = currentInputs.find(clientID);
+    return it != currentInputs.end() ? it->second.processed : 0;
+}
+
+std::unordered_map<uint32_t, uint32_t> ServerInputManager::GetProcessedInputs() const {
+    std::lock_guard<std::mutex> lock(inputMutex);
+
+    std::unordered_map<uint32_t, uint32_t> processed;
+    for (const auto& [clientID, inputs] : currentInputs) {
+        if (inputs.processed != 0) {
+            processed[clientID] = inputs.processed;
+        }
+    }
+    return processed;
+}
+
+void ServerInputManager::RemoveClient(uint32_t clientID) {
+    std::lock_guard<std::mutex> lock(inputMutex);
+    currentInputs.erase(clientID);
+}
+
 void ServerInputManager::ClearProcessedInputs() {
     std::lock_guard<std::mutex> lock(inputMutex);
 }
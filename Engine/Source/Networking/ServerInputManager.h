@@ -3,6 +3,7 @@
 
 #include "NetworkProtocol.h"
 #include <unordered_map>
+#include <array>
 #include <mutex>
 
 namespace RiverCore {
@@ -13,14 +14,28 @@ public:
     ~ServerInputManager() = default;
 
     // Queue an input from a client
+    // Sequenced inputs are applied one per tick in order (stale or repeated ones are dropped), unsequenced
+    // inputs replace the client's current input immediately
     void QueueInput(const InputState& input);
 
+    // Advance every client to its next queued input command (called once per simulation tick)
+    // Clients with nothing queued keep their current input
+    void AdvanceInputs();
+
     // Get the latest input for a specific client
     InputState GetInputForClient(uint32_t clientID) const;
 
     // Check if a client has any input
     bool HasInputForClient(uint32_t clientID) const;
 
+    // Get the sequence of the last input command applied for a client (0 = none)
+    uint32_t GetLastProcessedInput(uint32_t clientID) const;
+    // Get the sequence of the last input command applied for every client that sent one (clientID -> sequence)
+    std::unordered_map<uint32_t, uint32_t> GetProcessedInputs() const;
+
+    // Forget a client's inputs (called when it disconnects)
+    void RemoveClient(uint32_t clientID);
+
     // Clear all processed inputs (called after each simulation frame)
     void ClearProcessedInputs();
 
@@ -28,9 +43,22 @@ public:
     std::vector<uint32_t> GetActiveClients() const;
 
 private:
+    // Queued commands kept per client; a client further ahead than this has its oldest commands dropped
+    static constexpr size_t MAX_QUEUED_INPUTS = 8;
+
+    struct ClientInputs {
+        InputState current;
+        // Sequenced commands not applied yet, a ring starting at queuedStart
+        std::array<InputState, MAX_QUEUED_INPUTS> queued;
+        size_t queuedStart = 0;
+        size_t queuedCount = 0;
+        uint32_t lastQueued = 0;        // Highest sequence queued so far
+        uint32_t processed = 0;         // Sequence of current, if it was sequenced
+    };
+
     // Store the most recent input for each client
     mutable std::mutex inputMutex;
-    std::unordered_map<uint32_t, InputState> currentInputs;
+    std::unordered_map<uint32_t, ClientInputs> currentInputs;
 };
 
 }
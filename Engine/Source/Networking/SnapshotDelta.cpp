@@ -0,0 +1,489 @@
+#include "SnapshotDelta.h"
+#include <algorithm>
+#include <iterator>
+#include <cmath>
+
+namespace RiverCore {
+
+namespace {
+
+// Changed-field mask bits of a delta entity record
+constexpr uint32_t DELTA_POSITION = 1 << 0;
+constexpr uint32_t DELTA_VELOCITY = 1 << 1;
+constexpr uint32_t DELTA_SCALE = 1 << 2;
+constexpr uint32_t DELTA_ROTATION = 1 << 3;
+constexpr uint32_t DELTA_FLIP = 1 << 4;
+constexpr uint32_t DELTA_FRAME = 1 << 5;
+constexpr int DELTA_MASK_BITS = 6;
+
+// Entity fields in their stored form
+// Changes are detected on these, so motion below the quantization resolution is never resent and the
+// receiver's copy of an unchanged field always equals what it would decode from the current value
+struct QuantizedEntity {
+    uint32_t positionX = 0;
+    uint32_t positionY = 0;
+    uint32_t velocityX = 0;
+    uint32_t velocityY = 0;
+    uint32_t scaleX = 0;
+    uint32_t scaleY = 0;
+    uint32_t rotation = 0;
+    uint32_t flip = 0;
+    uint32_t frame = 0;
+};
+
+int RotationBits(const SnapshotQuantization& quantization) {
+    return (quantization.rotationBits > 0 && quantization.rotationBits < 32) ? quantization.rotationBits : 32;
+}
+
+int FrameBits(const SnapshotQuantization& quantization) {
+    return (quantization.frameBits > 0 && quantization.frameBits < 32) ? quantization.frameBits : 32;
+}
+
+uint32_t QuantizeRotation(float rotation, int bits) {
+    if (bits >= 32) {
+        return QuantizedRange().Quantize(rotation);
+    }
+    double wrapped = std::fmod(static_cast<double>(rotation), 360.0);
+    if (!(wrapped >= 0.0)) {
+        wrapped = std::isnan(wrapped) ? 0.0 : wrapped + 360.0;
+    }
+    uint64_t steps = 1ull << bits;
+    return static_cast<uint32_t>(static_cast<uint64_t>(std::llround(wrapped / 360.0 * steps)) & (steps - 1));
+}
+
+float DequantizeRotation(uint32_t quantized, int bits) {
+    if (bits >= 32) {
+        return QuantizedRange().Dequantize(quantized);
+    }
+    return static_cast<float>(quantized * (360.0 / static_cast<double>(1ull << bits)));
+}
+
+QuantizedEntity Quantize(const EntitySnapshot& entity, const SnapshotQuantization& quantization) {
+    QuantizedEntity quantized;
+    quantized.positionX = quantization.positionX.Quantize(entity.position.x);
+    quantized.positionY = quantization.positionY.Quantize(entity.position.y);
+    quantized.velocityX = quantization.velocity.Quantize(entity.velocity.x);
+    quantized.velocityY = quantization.velocity.Quantize(entity.velocity.y);
+    quantized.scaleX = quantization.scale.Quantize(entity.scale.x);
+    quantized.scaleY = quantization.scale.Quantize(entity.scale.y);
+    quantized.rotation = QuantizeRotation(entity.rotation, RotationBits(quantization));
+    quantized.flip = (entity.flipX ? 1u : 0u) | (entity.flipY ? 2u : 0u);
+
+    int frameBits = FrameBits(quantization);
+    uint32_t maxFrame = frameBits >= 32 ? 0xFFFFFFFFu : (1u << frameBits) - 1u;
+    uint32_t frame = entity.currentFrame > 0 ? static_cast<uint32_t>(entity.currentFrame) : 0u;
+    quantized.frame = frame < maxFrame ? frame : maxFrame;
+    return quantized;
+}
+
+EntitySnapshot Dequantize(uint32_t entityID, const QuantizedEntity& quantized, const SnapshotQuantization& quantization) {
+    EntitySnapshot entity;
+    entity.entityID = entityID;
+    entity.position.x = quantization.positionX.Dequantize(quantized.positionX);
+    entity.position.y = quantization.positionY.Dequantize(quantized.positionY);
+    entity.velocity.x = quantization.velocity.Dequantize(quantized.velocityX);
+    entity.velocity.y = quantization.velocity.Dequantize(quantized.velocityY);
+    entity.scale.x = quantization.scale.Dequantize(quantized.scaleX);
+    entity.scale.y = quantization.scale.Dequantize(quantized.scaleY);
+    entity.rotation = DequantizeRotation(quantized.rotation, RotationBits(quantization));
+    entity.flipX = (quantized.flip & 1u) != 0;
+    entity.flipY = (quantized.flip & 2u) != 0;
+    entity.currentFrame = static_cast<int>(quantized.frame);
+    return entity;
+}
+
+uint32_t ChangedFields(const QuantizedEntity& from, const QuantizedEntity& to) {
+    uint32_t mask = 0;
+    if (from.positionX != to.positionX || from.positionY != to.positionY) mask |= DELTA_POSITION;
+    if (from.velocityX != to.velocityX || from.velocityY != to.velocityY) mask |= DELTA_VELOCITY;
+    if (from.scaleX != to.scaleX || from.scaleY != to.scaleY) mask |= DELTA_SCALE;
+    if (from.rotation != to.rotation) mask |= DELTA_ROTATION;
+    if (from.flip != to.flip) mask |= DELTA_FLIP;
+    if (from.frame != to.frame) mask |= DELTA_FRAME;
+    return mask;
+}
+
+void WriteEntityDelta(BitWriter& writer, uint32_t idGap, const QuantizedEntity& entity, uint32_t mask,
+                      const SnapshotQuantization& quantization) {
+    writer.WriteVarBits(idGap);
+    writer.WriteBits(mask, DELTA_MASK_BITS);
+    if (mask & DELTA_POSITION) {
+        writer.WriteBits(entity.positionX, quantization.positionX.Bits());
+        writer.WriteBits(entity.positionY, quantization.positionY.Bits());
+    }
+    if (mask & DELTA_VELOCITY) {
+        writer.WriteBits(entity.velocityX, quantization.velocity.Bits());
+        writer.WriteBits(entity.velocityY, quantization.velocity.Bits());
+    }
+    if (mask & DELTA_SCALE) {
+        writer.WriteBits(entity.scaleX, quantization.scale.Bits());
+        writer.WriteBits(entity.scaleY, quantization.scale.Bits());
+    }
+    if (mask & DELTA_ROTATION) {
+        writer.WriteBits(entity.rotation, RotationBits(quantization));
+    }
+    if (mask & DELTA_FLIP) {
+        writer.WriteBits(entity.flip, 2);
+    }
+    if (mask & DELTA_FRAME) {
+        writer.WriteBits(entity.frame, FrameBits(quantization));
+    }
+}
+
+// Applies the fields of a delta record (the ID gap was already read) on top of an entity
+void ReadEntityDelta(BitReader& reader, EntitySnapshot& entity, const SnapshotQuantization& quantization) {
+    uint32_t mask = reader.ReadBits(DELTA_MASK_BITS);
+    if (mask & DELTA_POSITION) {
+        entity.position.x = reader.ReadQuantized(quantization.positionX);
+        entity.position.y = reader.ReadQuantized(quantization.positionY);
+    }
+    if (mask & DELTA_VELOCITY) {
+        entity.velocity.x = reader.ReadQuantized(quantization.velocity);
+        entity.velocity.y = reader.ReadQuantized(quantization.velocity);
+    }
+    if (mask & DELTA_SCALE) {
+        entity.scale.x = reader.ReadQuantized(quantization.scale);
+        entity.scale.y = reader.ReadQuantized(quantization.scale);
+    }
+    if (mask & DELTA_ROTATION) {
+        int bits = RotationBits(quantization);
+        entity.rotation = DequantizeRotation(reader.ReadBits(bits), bits);
+    }
+    if (mask & DELTA_FLIP) {
+        uint32_t flip = reader.ReadBits(2);
+        entity.flipX = (flip & 1u) != 0;
+        entity.flipY = (flip & 2u) != 0;
+    }
+    if (mask & DELTA_FRAME) {
+        entity.currentFrame = static_cast<int>(reader.ReadBits(FrameBits(quantization)));
+    }
+}
+
+void WriteRange(ByteWriter& writer, const QuantizedRange& range) {
+    writer.WriteF32(range.min);
+    writer.WriteF32(range.max);
+    writer.WriteF32(range.resolution);
+}
+
+QuantizedRange ReadRange(ByteReader& reader) {
+    QuantizedRange range;
+    range.min = reader.ReadF32();
+    range.max = reader.ReadF32();
+    range.resolution = reader.ReadF32();
+    return range;
+}
+
+}
+
+std::string SnapshotQuantization::Serialize() const {
+    std::string data;
+    ByteWriter writer(data);
+    WriteRange(writer, positionX);
+    WriteRange(writer, positionY);
+    WriteRange(writer, velocity);
+    WriteRange(writer, scale);
+    writer.WriteU8(static_cast<uint8_t>(rotationBits));
+    writer.WriteU8(static_cast<uint8_t>(frameBits));
+    return data;
+}
+
+SnapshotQuantization SnapshotQuantization::Deserialize(const std::string& data) {
+    SnapshotQuantization quantization;
+    ByteReader reader(data);
+    quantization.positionX = ReadRange(reader);
+    quantization.positionY = ReadRange(reader);
+    quantization.velocity = ReadRange(reader);
+    quantization.scale = ReadRange(reader);
+    quantization.rotationBits = reader.ReadU8();
+    quantization.frameBits = reader.ReadU8();
+    return reader.Failed() ? SnapshotQuantization() : quantization;
+}
+
+void SnapshotHistory::Store(std::shared_ptr<const GameStateSnapshot> snapshot) {
+    if (snapshot) {
+        slots[snapshot->snapshotID % SNAPSHOT_HISTORY_SIZE] = std::move(snapshot);
+    }
+}
+
+std::shared_ptr<const GameStateSnapshot> SnapshotHistory::Find(uint32_t snapshotID) const {
+    if (snapshotID == 0) {
+        return nullptr;
+    }
+    const std::shared_ptr<const GameStateSnapshot>& slot = slots[snapshotID % SNAPSHOT_HISTORY_SIZE];
+    if (slot && slot->snapshotID == snapshotID) {
+        return slot;
+    }
+    return nullptr;
+}
+
+void SnapshotHistory::Clear() {
+    for (auto& slot : slots) {
+        slot.reset();
+    }
+}
+
+std::string SerializeSnapshotDelta(const GameStateSnapshot& baseline, const GameStateSnapshot& current,
+                                   const SnapshotQuantization& quantization) {
+    std::string data;
+    ByteWriter writer(data);
+    writer.WriteU32(current.snapshotID);
+    writer.WriteU32(baseline.snapshotID);
+    writer.WriteU64(current.timestamp);
+
+    // Walk both ID-sorted entity lists together, writing changed and new entities and collecting removed ones
+    const QuantizedEntity defaults = Quantize(EntitySnapshot(), quantization);
+    std::vector<uint32_t> removed;
+    uint32_t changedCount = 0;
+
+    size_t section = writer.BeginSection();
+    size_t countOffset = writer.Size();
+    writer.WriteU32(0);
+    {
+        BitWriter bits(data);
+        uint32_t previousID = 0;
+        size_t b = 0;
+        for (const EntitySnapshot& entity : current.entities) {
+            while (b < baseline.entities.size() && baseline.entities[b].entityID < entity.entityID) {
+                removed.push_back(baseline.entities[b].entityID);
+                ++b;
+            }
+
+            QuantizedEntity quantized = Quantize(entity, quantization);
+            uint32_t mask;
+            if (b < baseline.entities.size() && baseline.entities[b].entityID == entity.entityID) {
+                mask = ChangedFields(Quantize(baseline.entities[b], quantization), quantized);
+                ++b;
+                if (mask == 0) {
+                    continue;
+                }
+            } else {
+                // New entity: always written (even with all-default fields) so the receiver learns it exists
+                mask = ChangedFields(defaults, quantized);
+            }
+
+            WriteEntityDelta(bits, entity.entityID - previousID, quantized, mask, quantization);
+            previousID = entity.entityID;
+            ++changedCount;
+        }
+        for (; b < baseline.entities.size(); ++b) {
+            removed.push_back(baseline.entities[b].entityID);
+        }
+    }
+    writer.PatchU32(countOffset, changedCount);
+    writer.EndSection(section);
+
+    section = writer.BeginSection();
+    writer.WriteU32(static_cast<uint32_t>(removed.size()));
+    {
+        BitWriter bits(data);
+        uint32_t previousID = 0;
+        for (uint32_t entityID : removed) {
+            bits.WriteVarBits(entityID - previousID);
+            previousID = entityID;
+        }
+    }
+    writer.EndSection(section);
+
+    // Player bindings rarely change, so they are only resent when they differ from the baseline
+    section = writer.BeginSection();
+    bool bindingsChanged = current.playerEntityBindings != baseline.playerEntityBindings;
+    writer.WriteBool(bindingsChanged);
+    if (bindingsChanged) {
+        writer.WriteU32(static_cast<uint32_t>(current.playerEntityBindings.size()));
+        for (const auto& [clientID, entityID] : current.playerEntityBindings) {
+            writer.WriteU32(clientID);
+            writer.WriteU32(entityID);
+        }
+    }
+    writer.EndSection(section);
+
+    return data;
+}
+
+std::string SerializeSpawnChunk(const std::vector<EntitySpawnInfo>& spawns, const SnapshotQuantization& quantization) {
+    std::string data;
+    ByteWriter writer(data);
+
+    size_t section = writer.BeginSection();
+    writer.WriteU32(static_cast<uint32_t>(spawns.size()));
+    {
+        BitWriter bits(data);
+        const QuantizedRange exact;
+        int rotationBits = RotationBits(quantization);
+        uint32_t previousID = 0;
+        for (const EntitySpawnInfo& spawn : spawns) {
+            bits.WriteVarBits(spawn.entityID - previousID);
+            previousID = spawn.entityID;
+            bits.WriteVarBits(spawn.spriteID);
+            bits.WriteVarBits(static_cast<uint32_t>(std::max(spawn.totalFrames, 0)));
+            bits.WriteQuantized(spawn.fps, exact);
+            bits.WriteQuantized(spawn.position.x, quantization.positionX);
+            bits.WriteQuantized(spawn.position.y, quantization.positionY);
+            bits.WriteQuantized(spawn.scale.x, quantization.scale);
+            bits.WriteQuantized(spawn.scale.y, quantization.scale);
+            bits.WriteBits(QuantizeRotation(spawn.rotation, rotationBits), rotationBits);
+            bits.WriteBool(spawn.physEnabled);
+            bits.WriteVarBits(static_cast<uint32_t>(std::max(spawn.colliderType, 0)));
+            bits.WriteVarBits(spawn.ownerClientID);
+        }
+    }
+    writer.EndSection(section);
+
+    return data;
+}
+
+bool DeserializeSpawnChunk(const std::string& data, const SnapshotQuantization& quantization,
+                           std::vector<EntitySpawnInfo>& spawns) {
+    ByteReader reader(data);
+    ByteReader spawnSection = reader.ReadSection();
+
+    std::vector<EntitySpawnInfo> chunk;
+    uint32_t spawnCount = spawnSection.ReadU32();
+    BitReader bits(spawnSection.Current(), spawnSection.Remaining());
+    const QuantizedRange exact;
+    int rotationBits = RotationBits(quantization);
+    uint32_t previousID = 0;
+    for (uint32_t i = 0; i < spawnCount && !bits.Failed(); ++i) {
+        EntitySpawnInfo spawn;
+        spawn.entityID = previousID + bits.ReadVarBits();
+        previousID = spawn.entityID;
+        spawn.spriteID = bits.ReadVarBits();
+        spawn.totalFrames = static_cast<int>(bits.ReadVarBits());
+        spawn.fps = bits.ReadQuantized(exact);
+        spawn.position.x = bits.ReadQuantized(quantization.positionX);
+        spawn.position.y = bits.ReadQuantized(quantization.positionY);
+        spawn.scale.x = bits.ReadQuantized(quantization.scale);
+        spawn.scale.y = bits.ReadQuantized(quantization.scale);
+        spawn.rotation = DequantizeRotation(bits.ReadBits(rotationBits), rotationBits);
+        spawn.physEnabled = bits.ReadBool();
+        spawn.colliderType = static_cast<int>(bits.ReadVarBits());
+        spawn.ownerClientID = bits.ReadVarBits();
+        chunk.push_back(std::move(spawn));
+    }
+
+    if (reader.Failed() || spawnSection.Failed() || bits.Failed()) {
+        return false;
+    }
+
+    spawns.insert(spawns.end(), std::make_move_iterator(chunk.begin()), std::make_move_iterator(chunk.end()));
+    return true;
+}
+
+size_t GetEntityDeltaBits(const EntitySnapshot* baseline, const EntitySnapshot& current,
+                          const SnapshotQuantization& quantization) {
+    QuantizedEntity quantized = Quantize(current, quantization);
+    uint32_t mask;
+    if (baseline) {
+        mask = ChangedFields(Quantize(*baseline, quantization), quantized);
+        if (mask == 0) {
+            return 0;
+        }
+    } else {
+        mask = ChangedFields(Quantize(EntitySnapshot(), quantization), quantized);
+    }
+
+    // Same layout as WriteEntityDelta
+    size_t bits = DELTA_MASK_BITS;
+    if (mask & DELTA_POSITION) bits += quantization.positionX.Bits() + quantization.positionY.Bits();
+    if (mask & DELTA_VELOCITY) bits += 2 * quantization.velocity.Bits();
+    if (mask & DELTA_SCALE) bits += 2 * quantization.scale.Bits();
+    if (mask & DELTA_ROTATION) bits += RotationBits(quantization);
+    if (mask & DELTA_FLIP) bits += 2;
+    if (mask & DELTA_FRAME) bits += FrameBits(quantization);
+    return bits;
+}
+
+uint32_t GetSnapshotDeltaBaseline(const std::string& data) {
+    ByteReader reader(data);
+    reader.ReadU32();
+    uint32_t baselineID = reader.ReadU32();
+    return reader.Failed() ? 0 : baselineID;
+}
+
+bool DeserializeSnapshotDelta(const GameStateSnapshot& baseline, const std::string& data,
+                              const SnapshotQuantization& quantization, GameStateSnapshot& result) {
+    ByteReader reader(data);
+    uint32_t snapshotID = reader.ReadU32();
+    uint32_t baselineID = reader.ReadU32();
+    uint64_t timestamp = reader.ReadU64();
+    if (reader.Failed() || baselineID != baseline.snapshotID) {
+        return false;
+    }
+
+    ByteReader changedSection = reader.ReadSection();
+    ByteReader removedSection = reader.ReadSection();
+    ByteReader bindingSection = reader.ReadSection();
+
+    GameStateSnapshot snapshot;
+    snapshot.snapshotID = snapshotID;
+    snapshot.timestamp = timestamp;
+    snapshot.entities.reserve(baseline.entities.size());
+
+    std::vector<uint32_t> removed;
+    uint32_t removedCount = removedSection.ReadU32();
+    BitReader removedBits(removedSection.Current(), removedSection.Remaining());
+    uint32_t previousID = 0;
+    for (uint32_t i = 0; i < removedCount && !removedBits.Failed(); ++i) {
+        previousID += removedBits.ReadVarBits();
+        removed.push_back(previousID);
+    }
+
+    // Copies baseline entities with IDs below a limit, skipping removed ones (both lists are ID-sorted)
+    size_t b = 0;
+    size_t r = 0;
+    auto copyBaselineUpTo = [&](uint64_t limit) {
+        for (; b < baseline.entities.size() && baseline.entities[b].entityID < limit; ++b) {
+            const EntitySnapshot& entity = baseline.entities[b];
+            while (r < removed.size() && removed[r] < entity.entityID) {
+                ++r;
+            }
+            if (r < removed.size() && removed[r] == entity.entityID) {
+                continue;
+            }
+            snapshot.entities.push_back(entity);
+        }
+    };
+
+    // New entities start from the default fields as the sender quantized them
+    const EntitySnapshot defaults = Dequantize(0, Quantize(EntitySnapshot(), quantization), quantization);
+
+    uint32_t changedCount = changedSection.ReadU32();
+    BitReader changedBits(changedSection.Current(), changedSection.Remaining());
+    previousID = 0;
+    for (uint32_t i = 0; i < changedCount && !changedBits.Failed(); ++i) {
+        uint32_t entityID = previousID + changedBits.ReadVarBits();
+        previousID = entityID;
+        copyBaselineUpTo(entityID);
+
+        if (b < baseline.entities.size() && baseline.entities[b].entityID == entityID) {
+            snapshot.entities.push_back(baseline.entities[b]);
+            ++b;
+        } else {
+            snapshot.entities.push_back(defaults);
+            snapshot.entities.back().entityID = entityID;
+        }
+        ReadEntityDelta(changedBits, snapshot.entities.back(), quantization);
+    }
+    copyBaselineUpTo(UINT64_MAX);
+
+    if (bindingSection.ReadBool()) {
+        uint32_t bindingCount = bindingSection.ReadU32();
+        for (uint32_t i = 0; i < bindingCount && !bindingSection.Failed(); ++i) {
+            uint32_t clientID = bindingSection.ReadU32();
+            uint32_t entityID = bindingSection.ReadU32();
+            snapshot.playerEntityBindings[clientID] = entityID;
+        }
+    } else {
+        snapshot.playerEntityBindings = baseline.playerEntityBindings;
+    }
+
+    if (reader.Failed() || changedSection.Failed() || changedBits.Failed() || removedSection.Failed() ||
+        removedBits.Failed() || bindingSection.Failed()) {
+        return false;
+    }
+
+    result = std::move(snapshot);
+    return true;
+}
+
+}
@@ -0,0 +1,82 @@
+#ifndef SNAPSHOTDELTA_H
+#define SNAPSHOTDELTA_H
+
+#include "NetworkProtocol.h"
+#include "BitStream.h"
+#include <memory>
+#include <array>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace RiverCore {
+
+// Number of snapshots kept as potential delta baselines, on both the server (per client) and the client
+// The server only encodes against a baseline it still holds, and any baseline it holds is at most this many
+// snapshots old, so the client is guaranteed to still have it
+constexpr uint32_t SNAPSHOT_HISTORY_SIZE = 32;
+
+// Quantization of the entity fields in delta-encoded snapshots
+// Positions are stored relative to the world bounds; a range with zero resolution is sent as an exact float.
+// The server sends its settings to each client when it connects.
+struct SnapshotQuantization {
+    QuantizedRange positionX{-32768.0f, 32768.0f - 1.0f / 16.0f, 1.0f / 16.0f};  // 20 bits at 1/16 px
+    QuantizedRange positionY{-32768.0f, 32768.0f - 1.0f / 16.0f, 1.0f / 16.0f};
+    QuantizedRange velocity{-4096.0f, 4096.0f, 1.0f / 16.0f};                    // 18 bits per axis
+    QuantizedRange scale{-64.0f, 64.0f - 1.0f / 256.0f, 1.0f / 256.0f};          // 15 bits per axis
+    int rotationBits = 10;      // Rotation wrapped to [0, 360) degrees; 0 sends an exact float
+    int frameBits = 8;          // Animation frames above 2^frameBits - 1 are clamped
+
+    // Serialization
+    std::string Serialize() const;
+    static SnapshotQuantization Deserialize(const std::string& data);
+};
+
+// Ring of recent snapshots indexed by snapshot ID
+class SnapshotHistory {
+public:
+    // Stores a snapshot, replacing the one SNAPSHOT_HISTORY_SIZE IDs older
+    void Store(std::shared_ptr<const GameStateSnapshot> snapshot);
+    // Returns the snapshot with an ID, or null if it is unknown or was already replaced
+    std::shared_ptr<const GameStateSnapshot> Find(uint32_t snapshotID) const;
+    // Forgets every snapshot
+    void Clear();
+
+private:
+    std::array<std::shared_ptr<const GameStateSnapshot>, SNAPSHOT_HISTORY_SIZE> slots;
+};
+
+// Encodes a snapshot relative to a baseline the receiver already has
+// Only entities whose quantized fields changed are written, as a bit-packed record (ID gap, changed-field
+// mask, quantized fields), followed by the IDs of entities that disappeared; an entity identical to its
+// baseline costs zero bytes. Encoding against an empty baseline with ID 0 produces a keyframe.
+// Both snapshots must have their entities sorted by entity ID.
+std::string SerializeSnapshotDelta(const GameStateSnapshot& baseline, const GameStateSnapshot& current,
+                                   const SnapshotQuantization& quantization);
+
+// Encodes a batch of spawn records (sorted by entity ID) compactly, for streaming the world to a joining client
+// Sprites are referenced by asset ID; positions, scales and rotations use the snapshot quantization, which
+// the receiver must already have.
+std::string SerializeSpawnChunk(const std::vector<EntitySpawnInfo>& spawns, const SnapshotQuantization& quantization);
+
+// Appends the spawn records of a batch to spawns (sprite paths left to resolve from their asset IDs)
+// Returns false if the payload is malformed
+bool DeserializeSpawnChunk(const std::string& data, const SnapshotQuantization& quantization,
+                           std::vector<EntitySpawnInfo>& spawns);
+
+// Returns the size in bits of an entity's record in a delta against a baseline copy of it (null if the
+// baseline lacks the entity), not counting its ID gap; 0 if no field changed at the quantized resolution
+size_t GetEntityDeltaBits(const EntitySnapshot* baseline, const EntitySnapshot& current,
+                          const SnapshotQuantization& quantization);
+
+// Returns the baseline snapshot ID a delta payload was encoded against (0 for keyframes and malformed payloads)
+uint32_t GetSnapshotDeltaBaseline(const std::string& data);
+
+// Rebuilds the full snapshot from a delta payload and the baseline it was encoded against
+// (an empty snapshot for keyframes); fields come back dequantized
+// Returns false if the payload is malformed or was encoded against a different baseline
+bool DeserializeSnapshotDelta(const GameStateSnapshot& baseline, const std::string& data,
+                              const SnapshotQuantization& quantization, GameStateSnapshot& result);
+}
+
+#endif
@@ -0,0 +1,113 @@
+#include "SnapshotInterpolator.h"
+#include <algorithm>
+#include <cmath>
+
+namespace RiverCore {
+
+namespace {
+
+double ToSeconds(SnapshotInterpolator::Clock::time_point time) {
+    return std::chrono::duration<double>(time.time_since_epoch()).count();
+}
+
+Vec2 Lerp(const Vec2& from, const Vec2& to, float alpha) {
+    return Vec2(from.x + (to.x - from.x) * alpha, from.y + (to.y - from.y) * alpha);
+}
+
+// Interpolates rotations in degrees along the shorter arc
+float LerpRotation(float from, float to, float alpha) {
+    float difference = std::fmod(to - from, 360.0f);
+    if (difference > 180.0f) {
+        difference -= 360.0f;
+    } else if (difference < -180.0f) {
+        difference += 360.0f;
+    }
+    return from + difference * alpha;
+}
+
+}
+
+void SnapshotInterpolator::Add(std::shared_ptr<const GameStateSnapshot> snapshot, Clock::time_point receivedAt) {
+    double serverTime = static_cast<double>(snapshot->timestamp) / 1000.0;
+    double offset = ToSeconds(receivedAt) - serverTime;
+
+    // Track the server clock, starting over if it jumped (e.g. the server restarted)
+    if (!hasClockOffset || std::abs(offset - clockOffset) > CLOCK_RESET_THRESHOLD) {
+        clockOffset = offset;
+        hasClockOffset = true;
+        entries.clear();
+    } else {
+        clockOffset += (offset - clockOffset) * CLOCK_SMOOTHING;
+    }
+
+    if (!entries.empty() && serverTime <= entries.back().serverTime) {
+        return;
+    }
+
+    entries.push_back({serverTime, std::move(snapshot)});
+    while (entries.size() > MAX_ENTRIES) {
+        entries.pop_front();
+    }
+}
+
+bool SnapshotInterpolator::Sample(Clock::time_point now, GameStateSnapshot& result) {
+    if (entries.empty()) {
+        return false;
+    }
+
+    double renderTime = ToSeconds(now) - clockOffset - delay;
+
+    // Drop snapshots no longer needed, keeping the one at or before the render time
+    while (entries.size() >= 2 && entries[1].serverTime <= renderTime) {
+        entries.pop_front();
+    }
+
+    const Entry& from = entries[0];
+    if (entries.size() == 1 || renderTime <= from.serverTime) {
+        // Nothing to blend towards yet (or the buffer is still filling), hold the oldest snapshot
+        result = *from.snapshot;
+        return true;
+    }
+
+    const Entry& to = entries[1];
+    float alpha = static_cast<float>((renderTime - from.serverTime) / (to.serverTime - from.serverTime));
+    Blend(*from.snapshot, *to.snapshot, std::clamp(alpha, 0.0f, 1.0f), result);
+    return true;
+}
+
+void SnapshotInterpolator::Clear() {
+    entries.clear();
+    hasClockOffset = false;
+}
+
+void SnapshotInterpolator::Blend(const GameStateSnapshot& from, const GameStateSnapshot& to, float alpha,
+                                 GameStateSnapshot& result) {
+    result.entities.clear();
+    result.entities.reserve(std::max(from.entities.size(), to.entities.size()));
+    result.playerEntityBindings = to.playerEntityBindings;
+    result.timestamp = to.timestamp;
+    result.snapshotID = to.snapshotID;
+
+    // Merge walk over the ID-sorted entities of both snapshots
+    auto a = from.entities.begin();
+    auto b = to.entities.begin();
+    while (a != from.entities.end() || b != to.entities.end()) {
+        if (b == to.entities.end() || (a != from.entities.end() && a->entityID < b->entityID)) {
+            result.entities.push_back(*a++);
+        } else if (a == from.entities.end() || b->entityID < a->entityID) {
+            result.entities.push_back(*b++);
+        } else {
+            // Continuous fields are blended, discrete ones switch halfway
+            EntitySnapshot entity = alpha < 0.5f ? *a : *b;
+            entity.position = Lerp(a->position, b->position, alpha);
+            entity.velocity = Lerp(a->velocity, b->velocity, alpha);
+            entity.scale = Lerp(a->scale, b->scale, alpha);
+            entity.rotation = LerpRotation(a->rotation, b->rotation, alpha);
+            result.entities.push_back(entity);
+            ++a;
+            ++b;
+        }
+    }
+}
+
+}
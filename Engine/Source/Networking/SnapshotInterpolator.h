@@ -0,0 +1,61 @@
+#ifndef SNAPSHOTINTERPOLATOR_H
+#define SNAPSHOTINTERPOLATOR_H
+
+#include "NetworkProtocol.h"
+#include <chrono>
+#include <deque>
+#include <memory>
+
+namespace RiverCore {
+
+// Buffer of received snapshots that renders the world a fixed delay in the past, blending the two snapshots
+// bracketing the render time
+// Snapshots are placed on the server's timeline by their timestamp, and the server clock is estimated from
+// their arrival times, so motion stays smooth however irregularly the snapshots arrive. The delay should
+// cover a couple of snapshot intervals plus the arrival jitter.
+class SnapshotInterpolator {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Set how far behind the estimated server time the world is rendered, in seconds
+    void SetDelay(float seconds) { delay = seconds; }
+    // Get how far behind the estimated server time the world is rendered, in seconds
+    float GetDelay() const { return delay; }
+
+    // Adds a received snapshot (entities sorted by ID); snapshots older than the newest one are ignored
+    void Add(std::shared_ptr<const GameStateSnapshot> snapshot, Clock::time_point receivedAt);
+    // Blends the buffered snapshots at the render time for a local time into result
+    // Entities are taken from the older snapshot if they are missing from the newer one and vice versa
+    // Returns false if no snapshot was received yet
+    bool Sample(Clock::time_point now, GameStateSnapshot& result);
+    // Forgets every snapshot and the server clock estimate
+    void Clear();
+
+private:
+    struct Entry {
+        double serverTime;  // Seconds on the server's clock
+        std::shared_ptr<const GameStateSnapshot> snapshot;
+    };
+    std::deque<Entry> entries;
+
+    // Local time minus server time of a snapshot's arrival, smoothed over recent snapshots
+    double clockOffset = 0.0;
+    bool hasClockOffset = false;
+
+    float delay = 0.1f;
+
+    // Snapshots kept when nothing samples the buffer
+    static constexpr size_t MAX_ENTRIES = 128;
+    // Weight of each new arrival in the clock offset estimate
+    static constexpr double CLOCK_SMOOTHING = 0.05;
+    // Offset change treated as a new server clock rather than jitter, in seconds
+    static constexpr double CLOCK_RESET_THRESHOLD = 1.0;
+
+    // Blends two snapshots' entities, alpha 0 giving from and 1 giving to
+    static void Blend(const GameStateSnapshot& from, const GameStateSnapshot& to, float alpha,
+                      GameStateSnapshot& result);
+};
+
+}
+
+#endif
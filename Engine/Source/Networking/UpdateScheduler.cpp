@@ -0,0 +1,123 @@
+#include "UpdateScheduler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace RiverCore {
+
+std::shared_ptr<const GameStateSnapshot> UpdateScheduler::Schedule(const GameStateSnapshot& current,
+                                                                   const GameStateSnapshot& baseline,
+                                                                   uint32_t viewerEntityID,
+                                                                   const BandwidthBudget& budget,
+                                                                   const SnapshotQuantization& quantization) {
+    // Credit the budget for the server time since the last snapshot, keeping only a little unused budget
+    float interval = 0.0f;
+    if (lastSent && current.timestamp > lastSent->timestamp) {
+        interval = std::min(static_cast<float>(current.timestamp - lastSent->timestamp) / 1000.0f, MAX_INTERVAL);
+    }
+    float maxCredit = std::max(budget.bytesPerSecond * MAX_CREDIT_SECONDS, MIN_MAX_CREDIT);
+    credit = std::min(credit + budget.bytesPerSecond * interval, maxCredit);
+
+    auto byID = [](const EntitySnapshot& entity, uint32_t id) { return entity.entityID < id; };
+
+    // Entities are weighted by their distance to the player entity
+    bool hasViewer = false;
+    Vec2 viewerPosition;
+    auto viewer = std::lower_bound(current.entities.begin(), current.entities.end(), viewerEntityID, byID);
+    if (viewer != current.entities.end() && viewer->entityID == viewerEntityID) {
+        hasViewer = true;
+        viewerPosition = viewer->position;
+    }
+
+    auto result = std::make_shared<GameStateSnapshot>();
+    result->timestamp = current.timestamp;
+    result->snapshotID = current.snapshotID;
+    result->playerEntityBindings = current.playerEntityBindings;
+    result->entities.reserve(current.entities.size());
+
+    // Walk the ID-sorted entities of the snapshot, its baseline, the last snapshot sent and the priorities
+    // together, sending what must be sent and collecting the rest as candidates
+    std::vector<std::pair<uint32_t, float>> nextPriorities;
+    nextPriorities.reserve(current.entities.size());
+    candidates.clear();
+    float requiredBytes = 0.0f;
+
+    size_t b = 0;
+    size_t s = 0;
+    size_t p = 0;
+    for (const EntitySnapshot& entity : current.entities) {
+        while (b < baseline.entities.size() && baseline.entities[b].entityID < entity.entityID) ++b;
+        while (p < priorities.size() && priorities[p].first < entity.entityID) ++p;
+        const EntitySnapshot* base = (b < baseline.entities.size() && baseline.entities[b].entityID == entity.entityID)
+            ? &baseline.entities[b] : nullptr;
+        const EntitySnapshot* sent = nullptr;
+        if (lastSent) {
+            const auto& sentEntities = lastSent->entities;
+            while (s < sentEntities.size() && sentEntities[s].entityID < entity.entityID) ++s;
+            if (s < sentEntities.size() && sentEntities[s].entityID == entity.entityID) {
+                sent = &sentEntities[s];
+            }
+        }
+        float accumulated = (p < priorities.size() && priorities[p].first == entity.entityID) ? priorities[p].second : 0.0f;
+
+        size_t bits = GetEntityDeltaBits(base, entity, quantization);
+        if (bits == 0) {
+            // Nothing to send
+            result->entities.push_back(entity);
+            nextPriorities.emplace_back(entity.entityID, 0.0f);
+            continue;
+        }
+
+        if (!sent || entity.entityID == viewerEntityID) {
+            // New to the client, or the player entity, which is always current as its prediction is
+            // reconciled against it
+            requiredBytes += static_cast<float>(bits + ID_GAP_BITS) / 8.0f;
+            result->entities.push_back(entity);
+            nextPriorities.emplace_back(entity.entityID, 0.0f);
+            continue;
+        }
+
+        float distance = 0.0f;
+        if (hasViewer) {
+            Vec2 offset = entity.position - viewerPosition;
+            distance = std::sqrt(offset.x * offset.x + offset.y * offset.y);
+        }
+        float weight = 1.0f / (1.0f + distance / std::max(budget.distanceFalloff, 1.0f));
+        nextPriorities.emplace_back(entity.entityID, accumulated + weight * interval);
+
+        // Without the budget the entity keeps the state the client has last been sent, so it never steps back;
+        // if that differs from the baseline, its record costs the same whether or not the entity wins
+        const EntitySnapshot* fallback = base;
+        float bytes = static_cast<float>(bits + ID_GAP_BITS) / 8.0f;
+        size_t sentBits = GetEntityDeltaBits(base, *sent, quantization);
+        if (!base || sentBits != 0) {
+            requiredBytes += static_cast<float>(sentBits + ID_GAP_BITS) / 8.0f;
+            fallback = sent;
+            bytes = bits > sentBits ? static_cast<float>(bits - sentBits) / 8.0f : 0.0f;
+        }
+
+        // Updating it to its current state competes for the rest of the budget
+        candidates.push_back({result->entities.size(), nextPriorities.size() - 1, &entity, bytes});
+        result->entities.push_back(*fallback);
+    }
+    credit -= requiredBytes;
+
+    // Fill the remaining budget in priority order, stopping at the first entity that does not fit so the
+    // highest priority one is never passed over for cheaper ones
+    std::sort(candidates.begin(), candidates.end(), [&nextPriorities](const Candidate& a, const Candidate& b) {
+        return nextPriorities[a.priorityIndex].second > nextPriorities[b.priorityIndex].second;
+    });
+    for (const Candidate& candidate : candidates) {
+        if (candidate.bytes > credit) {
+            break;
+        }
+        credit -= candidate.bytes;
+        result->entities[candidate.resultIndex] = *candidate.entity;
+        nextPriorities[candidate.priorityIndex].second = 0.0f;
+    }
+
+    priorities.swap(nextPriorities);
+    lastSent = result;
+    return result;
+}
+
+}
@@ -0,0 +1,69 @@
+#ifndef UPDATESCHEDULER_H
+#define UPDATESCHEDULER_H
+
+#include "NetworkProtocol.h"
+#include "SnapshotDelta.h"
+#include <memory>
+#include <utility>
+#include <vector>
+#include <cstdint>
+
+namespace RiverCore {
+
+// Limit on the entity updates sent to each client, and how the entities share it
+struct BandwidthBudget {
+    float bytesPerSecond = 0.0f;        // Entity record bytes sent to each client per second (0 = unlimited)
+    float distanceFalloff = 512.0f;     // Distance from the player entity at which an entity's priority halves
+
+    // Returns whether updates are limited at all
+    bool IsEnabled() const { return bytesPerSecond > 0.0f; }
+};
+
+// Chooses which changed entities a client's next snapshot updates, keeping its delta within a byte budget
+// Every entity with a pending change accumulates priority over time by its weight (higher near the player
+// entity), and the budget is filled in priority order. Sent entities start over, so the ones left out rise
+// until they are sent: distant entities update less often rather than never. The player entity itself is
+// always sent.
+// One scheduler per client, only touched by the thread encoding that client's updates.
+class UpdateScheduler {
+public:
+    // Builds the snapshot to send a client, to be delta-encoded against baseline (entities sorted by ID)
+    // Chosen entities carry their current state and the others the state last sent, which costs nothing in
+    // the delta unless it was sent since the baseline. New entities, the player entity and those repeated
+    // states (so the client never sees an entity step back) are always sent; that cost is charged to the
+    // budget first.
+    std::shared_ptr<const GameStateSnapshot> Schedule(const GameStateSnapshot& current,
+                                                      const GameStateSnapshot& baseline,
+                                                      uint32_t viewerEntityID, const BandwidthBudget& budget,
+                                                      const SnapshotQuantization& quantization);
+
+private:
+    // Accumulated priority of each entity of the last scheduled snapshot, sorted by entity ID
+    std::vector<std::pair<uint32_t, float>> priorities;
+    // The last snapshot scheduled
+    std::shared_ptr<const GameStateSnapshot> lastSent;
+    // Bytes the client may still be sent; negative after sending more than the budget allowed
+    float credit = 0.0f;
+
+    // Scratch list of the entities competing for the budget
+    struct Candidate {
+        size_t resultIndex;         // Index in the scheduled snapshot's entities
+        size_t priorityIndex;       // Index in priorities
+        const EntitySnapshot* entity;
+        float bytes;
+    };
+    std::vector<Candidate> candidates;
+
+    // Estimated bits of an entity's ID gap in the delta
+    static constexpr size_t ID_GAP_BITS = 10;
+    // Unused budget carried over to later snapshots, in seconds of budget
+    static constexpr float MAX_CREDIT_SECONDS = 0.25f;
+    // Unused budget carried over to later snapshots whatever the rate, so any single update eventually fits
+    static constexpr float MIN_MAX_CREDIT = 64.0f;
+    // Longest gap between snapshots credited to the budget, in seconds
+    static constexpr float MAX_INTERVAL = 1.0f;
+};
+
+}
+
+#endif
@@ -0,0 +1,51 @@
+#include "AABB.h"
+#include <cmath>
+#include <algorithm>
+
+namespace RiverCore {
+
+bool AABB::Raycast(const Vec2& origin, const Vec2& direction, float maxDistance, float& distance, Vec2& normal) const {
+    float tMin = 0.0f;
+    float tMax = maxDistance;
+    Vec2 hitNormal = Vec2::zero();
+
+    const float origins[2] = {origin.x, origin.y};
+    const float directions[2] = {direction.x, direction.y};
+    const float mins[2] = {minX, minY};
+    const float maxs[2] = {maxX, maxY};
+
+    for (int axis = 0; axis < 2; ++axis) {
+        if (std::abs(directions[axis]) < 1e-8f) {
+            // Parallel to this slab: miss unless the origin lies within it
+            if (origins[axis] < mins[axis] || origins[axis] > maxs[axis]) {
+                return false;
+            }
+            continue;
+        }
+
+        float inverse = 1.0f / directions[axis];
+        float t1 = (mins[axis] - origins[axis]) * inverse;
+        float t2 = (maxs[axis] - origins[axis]) * inverse;
+        float side = -1.0f; // Entering through the min face
+        if (t1 > t2) {
+            std::swap(t1, t2);
+            side = 1.0f;    // Entering through the max face
+        }
+
+        if (t1 > tMin) {
+            tMin = t1;
+            hitNormal = axis == 0 ? Vec2(side, 0.0f) : Vec2(0.0f, side);
+        }
+        tMax = std::min(tMax, t2);
+
+        if (tMin > tMax) {
+            return false;
+        }
+    }
+
+    distance = tMin;
+    normal = hitNormal;
+    return true;
+}
+
+}
@@ -0,0 +1,66 @@
+#ifndef AABB_H
+#define AABB_H
+
+#include "Math/Math.h"
+#include <cstdint>
+
+namespace RiverCore {
+
+// Axis-aligned bounding box in world space
+struct AABB {
+    float minX = 0.0f;
+    float minY = 0.0f;
+    float maxX = 0.0f;
+    float maxY = 0.0f;
+
+    // Returns whether two boxes overlap (touching edges do not count)
+    bool Overlaps(const AABB& other) const {
+        return minX < other.maxX && maxX > other.minX && minY < other.maxY && maxY > other.minY;
+    }
+
+    // Returns whether this box fully contains another box
+    bool Contains(const AABB& other) const {
+        return minX <= other.minX && minY <= other.minY && maxX >= other.maxX && maxY >= other.maxY;
+    }
+
+    // Returns the box grown by an amount on every side
+    AABB Expanded(float amount) const {
+        AABB result;
+        result.minX = minX - amount;
+        result.minY = minY - amount;
+        result.maxX = maxX + amount;
+        result.maxY = maxY + amount;
+        return result;
+    }
+
+    // Returns the perimeter of the box (surface area heuristic in 2D)
+    float Perimeter() const {
+        return 2.0f * ((maxX - minX) + (maxY - minY));
+    }
+
+    // Returns the smallest box containing two boxes
+    static AABB Combine(const AABB& a, const AABB& b) {
+        AABB result;
+        result.minX = a.minX < b.minX ? a.minX : b.minX;
+        result.minY = a.minY < b.minY ? a.minY : b.minY;
+        result.maxX = a.maxX > b.maxX ? a.maxX : b.maxX;
+        result.maxY = a.maxY > b.maxY ? a.maxY : b.maxY;
+        return result;
+    }
+
+    // Intersects a ray (normalized direction) with the box using the slab method
+    // Returns the entry distance and the normal of the entered face (zero if the origin is inside the box)
+    bool Raycast(const Vec2& origin, const Vec2& direction, float maxDistance, float& distance, Vec2& normal) const;
+};
+
+// Result of a raycast against entity collision bounds
+struct RaycastHit {
+    uint32_t entityID = 0;
+    Vec2 point = Vec2::zero();
+    Vec2 normal = Vec2::zero();
+    float distance = 0.0f;
+};
+
+}
+
+#endif
@@ -0,0 +1,78 @@
+#include "ContactTable.h"
+#include <algorithm>
+
+namespace RiverCore {
+
+void ContactTable::Update(const EntityStorage& storage) {
+    ++stepCount;
+    stepEvents.clear();
+
+    // Mark every pair touching in this step, recording the ones that just started
+    for (size_t i = 0; i < storage.Size(); ++i) {
+        uint32_t entityID = storage.ids[i];
+        for (const auto& [otherID, side] : storage.contacts[i]) {
+            // Each pair is stored once, from the point of view of the lower ID
+            bool isA = entityID < otherID;
+            uint32_t entityA = isA ? entityID : otherID;
+            uint32_t entityB = isA ? otherID : entityID;
+
+            auto [it, inserted] = pairs.try_emplace(MakeKey(entityA, entityB));
+            ContactPair& pair = it->second;
+            if (pair.lastStep == stepCount) {
+                continue; // Already seen from another side or from the other entity
+            }
+
+            // Sides are 0 top, 1 right, 2 bottom, 3 left, so the side seen by B is two steps around
+            pair.entityA = entityA;
+            pair.entityB = entityB;
+            pair.side = isA ? side : (side + 2) % 4;
+            pair.lastStep = stepCount;
+
+            // Pairs missing from the last step were erased, so every existing pair was touching then
+            stepEvents.push_back({entityA, entityB, pair.side, inserted ? CONTACT_BEGIN : CONTACT_STAY});
+        }
+    }
+
+    // Pairs not seen in this step have separated (or one of the entities was removed)
+    for (auto it = pairs.begin(); it != pairs.end();) {
+        if (it->second.lastStep != stepCount) {
+            stepEvents.push_back({it->second.entityA, it->second.entityB, it->second.side, CONTACT_END});
+            it = pairs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(eventMutex);
+    pendingEvents.insert(pendingEvents.end(), stepEvents.begin(), stepEvents.end());
+}
+
+void ContactTable::Flush(EventManager& eventManager) {
+    std::vector<ContactEvent> events;
+    {
+        std::lock_guard<std::mutex> lock(eventMutex);
+        events.swap(pendingEvents);
+    }
+
+    // Nothing reacts to collisions, so skip building the event payloads
+    if (!eventManager.HasHandlers(EVENT_TYPE_COLLISION)) {
+        events.clear();
+    }
+
+    for (const ContactEvent& event : events) {
+        EventData data(event.entityA);
+        data.secondaryEntityID = event.entityB;
+        data.collisionSide = event.side;
+        data.contactPhase = event.phase;
+        eventManager.Queue(EVENT_TYPE_COLLISION, data);
+    }
+
+    // Hand the buffer back so its capacity is reused
+    events.clear();
+    std::lock_guard<std::mutex> lock(eventMutex);
+    if (pendingEvents.empty()) {
+        pendingEvents.swap(events);
+    }
+}
+
+}
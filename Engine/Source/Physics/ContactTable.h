@@ -0,0 +1,67 @@
+#ifndef CONTACTTABLE_H
+#define CONTACTTABLE_H
+
+#include "Renderer/EntityStorage.h"
+#include "EventHandler/EventManager.h"
+#include <unordered_map>
+#include <vector>
+#include <mutex>
+#include <cstdint>
+
+namespace RiverCore {
+
+// Persistent table of touching entity pairs
+// After every collision step the pairs found in the contact columns are diffed against the previous step,
+// producing begin, stay and end events. The events are buffered until the thread that owns the event
+// manager flushes them, since the physics step may run on a different thread.
+class ContactTable {
+public:
+    ContactTable() = default;
+    ~ContactTable() = default;
+
+    // Diffs the contacts recorded by a collision step against the previous step and buffers the events
+    void Update(const EntityStorage& storage);
+    // Thread-safe function to queue the buffered events as EVENT_TYPE_COLLISION events and clear the buffer
+    // (the events are dropped if no collision handler is registered)
+    void Flush(EventManager& eventManager);
+
+    // Returns the number of touching pairs as of the last step
+    size_t GetPairCount() const { return pairs.size(); }
+
+private:
+    // Touching pair, keyed by both entity IDs (lower ID first)
+    struct ContactPair {
+        uint32_t entityA = 0;
+        uint32_t entityB = 0;
+        int side = 0;                  // Side of A that B touches (first one recorded)
+        uint64_t lastStep = 0;         // Last step the pair was touching in
+    };
+
+    // Contact change waiting to be flushed
+    struct ContactEvent {
+        uint32_t entityA;
+        uint32_t entityB;
+        int side;
+        ContactPhase phase;
+    };
+
+    // Mutex guarding the buffered events
+    std::mutex eventMutex;
+    // Touching pairs as of the last step
+    std::unordered_map<uint64_t, ContactPair> pairs;
+    // Events produced since the last flush
+    std::vector<ContactEvent> pendingEvents;
+    // Events produced by the current step (kept to reuse its capacity)
+    std::vector<ContactEvent> stepEvents;
+    // Number of steps diffed so far
+    uint64_t stepCount = 0;
+
+    // Builds the key of a pair from its entity IDs (lower ID first)
+    static uint64_t MakeKey(uint32_t entityA, uint32_t entityB) {
+        return (static_cast<uint64_t>(entityA) << 32) | entityB;
+    }
+};
+
+}
+
+#endif
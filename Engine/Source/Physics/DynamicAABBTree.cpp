@@ -0,0 +1,367 @@
+#include "DynamicAABBTree.h"
+#include <algorithm>
+
+namespace RiverCore {
+
+void DynamicAABBTree::SetMargin(float margin) {
+    if (margin >= 0.0f) {
+        fatMargin = margin;
+    }
+}
+
+int32_t DynamicAABBTree::CreateProxy(const AABB& bounds, uint32_t entityID, uint32_t index) {
+    int32_t proxyID = AllocateNode();
+    Node& node = nodes[proxyID];
+    node.tight = bounds;
+    node.fat = Fatten(bounds);
+    node.entityID = entityID;
+    node.index = index;
+    node.height = 0;
+
+    InsertLeaf(proxyID);
+    ++proxyCount;
+    return proxyID;
+}
+
+void DynamicAABBTree::DestroyProxy(int32_t proxyID) {
+    RemoveLeaf(proxyID);
+    FreeNode(proxyID);
+    --proxyCount;
+}
+
+bool DynamicAABBTree::MoveProxy(int32_t proxyID, const AABB& bounds) {
+    Node& node = nodes[proxyID];
+    node.tight = bounds;
+
+    // Still inside the fat AABB: the tree does not change
+    if (node.fat.Contains(bounds)) {
+        return false;
+    }
+
+    RemoveLeaf(proxyID);
+    nodes[proxyID].fat = Fatten(bounds);
+    InsertLeaf(proxyID);
+    return true;
+}
+
+void DynamicAABBTree::Clear() {
+    nodes.clear();
+    root = NULL_NODE;
+    freeList = NULL_NODE;
+    proxyCount = 0;
+}
+
+void DynamicAABBTree::Query(const AABB& bounds, std::vector<int32_t>& proxies) const {
+    Query(bounds, proxies, stack);
+}
+
+void DynamicAABBTree::Query(const AABB& bounds, std::vector<int32_t>& proxies, std::vector<int32_t>& traversalStack) const {
+    proxies.clear();
+    if (root == NULL_NODE) {
+        return;
+    }
+
+    traversalStack.clear();
+    traversalStack.push_back(root);
+    while (!traversalStack.empty()) {
+        int32_t nodeID = traversalStack.back();
+        traversalStack.pop_back();
+
+        const Node& node = nodes[nodeID];
+        // Inclusive test so touching fat boxes are still reported as candidates
+        if (node.fat.minX > bounds.maxX || node.fat.maxX < bounds.minX ||
+            node.fat.minY > bounds.maxY || node.fat.maxY < bounds.minY) {
+            continue;
+        }
+
+        if (node.IsLeaf()) {
+            proxies.push_back(nodeID);
+        } else {
+            traversalStack.push_back(node.child1);
+            traversalStack.push_back(node.child2);
+        }
+    }
+}
+
+bool DynamicAABBTree::Raycast(const Vec2& origin, const Vec2& direction, float maxDistance, RaycastHit& hit) const {
+    if (root == NULL_NODE) {
+        return false;
+    }
+
+    bool found = false;
+    float closest = maxDistance;
+
+    stack.clear();
+    stack.push_back(root);
+    while (!stack.empty()) {
+        int32_t nodeID = stack.back();
+        stack.pop_back();
+
+        const Node& node = nodes[nodeID];
+        float distance;
+        Vec2 normal;
+
+        // Prune subtrees the ray cannot reach before the closest hit so far
+        if (!node.fat.Raycast(origin, direction, closest, distance, normal)) {
+            continue;
+        }
+
+        if (node.IsLeaf()) {
+            if (node.tight.Raycast(origin, direction, closest, distance, normal) && (!found || distance < closest)) {
+                found = true;
+                closest = distance;
+                hit.entityID = node.entityID;
+                hit.distance = distance;
+                hit.normal = normal;
+                hit.point = origin + direction * distance;
+            }
+        } else {
+            stack.push_back(node.child1);
+            stack.push_back(node.child2);
+        }
+    }
+
+    return found;
+}
+
+int32_t DynamicAABBTree::AllocateNode() {
+    if (freeList == NULL_NODE) {
+        nodes.emplace_back();
+        return static_cast<int32_t>(nodes.size() - 1);
+    }
+
+    int32_t nodeID = freeList;
+    freeList = nodes[nodeID].parent;
+    nodes[nodeID] = Node();
+    return nodeID;
+}
+
+void DynamicAABBTree::FreeNode(int32_t nodeID) {
+    nodes[nodeID].parent = freeList;
+    nodes[nodeID].height = -1;
+    freeList = nodeID;
+}
+
+void DynamicAABBTree::InsertLeaf(int32_t leaf) {
+    if (root == NULL_NODE) {
+        root = leaf;
+        nodes[root].parent = NULL_NODE;
+        return;
+    }
+
+    // Descend to the best sibling, following the child that grows the total perimeter the least
+    AABB leafBounds = nodes[leaf].fat;
+    int32_t index = root;
+    while (!nodes[index].IsLeaf()) {
+        const Node& node = nodes[index];
+        float perimeter = node.fat.Perimeter();
+        float combinedPerimeter = AABB::Combine(node.fat, leafBounds).Perimeter();
+
+        // Cost of making a new parent for this node and the leaf
+        float cost = 2.0f * combinedPerimeter;
+        // Minimum cost of pushing the leaf further down the tree
+        float inheritanceCost = 2.0f * (combinedPerimeter - perimeter);
+
+        auto descendCost = [&](int32_t child) {
+            const Node& childNode = nodes[child];
+            float childCost = AABB::Combine(leafBounds, childNode.fat).Perimeter();
+            if (!childNode.IsLeaf()) {
+                childCost -= childNode.fat.Perimeter();
+            }
+            return childCost + inheritanceCost;
+        };
+
+        float cost1 = descendCost(node.child1);
+        float cost2 = descendCost(node.child2);
+
+        if (cost < cost1 && cost < cost2) {
+            break;
+        }
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    int32_t sibling = index;
+
+    // Create a new parent for the sibling and the leaf
+    int32_t oldParent = nodes[sibling].parent;
+    int32_t newParent = AllocateNode();
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].fat = AABB::Combine(leafBounds, nodes[sibling].fat);
+    nodes[newParent].height = nodes[sibling].height + 1;
+    nodes[newParent].child1 = sibling;
+    nodes[newParent].child2 = leaf;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    if (oldParent != NULL_NODE) {
+        if (nodes[oldParent].child1 == sibling) {
+            nodes[oldParent].child1 = newParent;
+        } else {
+            nodes[oldParent].child2 = newParent;
+        }
+    } else {
+        root = newParent;
+    }
+
+    Refit(nodes[leaf].parent);
+}
+
+void DynamicAABBTree::RemoveLeaf(int32_t leaf) {
+    if (leaf == root) {
+        root = NULL_NODE;
+        return;
+    }
+
+    int32_t parent = nodes[leaf].parent;
+    int32_t grandParent = nodes[parent].parent;
+    int32_t sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+    if (grandParent != NULL_NODE) {
+        // Replace the parent with the sibling
+        if (nodes[grandParent].child1 == parent) {
+            nodes[grandParent].child1 = sibling;
+        } else {
+            nodes[grandParent].child2 = sibling;
+        }
+        nodes[sibling].parent = grandParent;
+        FreeNode(parent);
+
+        Refit(grandParent);
+    } else {
+        root = sibling;
+        nodes[sibling].parent = NULL_NODE;
+        FreeNode(parent);
+    }
+}
+
+void DynamicAABBTree::Refit(int32_t nodeID) {
+    int32_t index = nodeID;
+    while (index != NULL_NODE) {
+        index = Balance(index);
+
+        Node& node = nodes[index];
+        const Node& child1 = nodes[node.child1];
+        const Node& child2 = nodes[node.child2];
+        node.height = 1 + std::max(child1.height, child2.height);
+        node.fat = AABB::Combine(child1.fat, child2.fat);
+
+        index = node.parent;
+    }
+}
+
+int32_t DynamicAABBTree::Balance(int32_t iA) {
+    Node& A = nodes[iA];
+    if (A.IsLeaf() || A.height < 2) {
+        return iA;
+    }
+
+    int32_t iB = A.child1;
+    int32_t iC = A.child2;
+    Node& B = nodes[iB];
+    Node& C = nodes[iC];
+
+    int32_t balance = C.height - B.height;
+
+    // Rotate C up
+    if (balance > 1) {
+        int32_t iF = C.child1;
+        int32_t iG = C.child2;
+        Node& F = nodes[iF];
+        Node& G = nodes[iG];
+
+        // Swap A and C
+        C.child1 = iA;
+        C.parent = A.parent;
+        A.parent = iC;
+
+        // A's old parent should point to C
+        if (C.parent != NULL_NODE) {
+            if (nodes[C.parent].child1 == iA) {
+                nodes[C.parent].child1 = iC;
+            } else {
+                nodes[C.parent].child2 = iC;
+            }
+        } else {
+            root = iC;
+        }
+
+        // Rotate
+        if (F.height > G.height) {
+            C.child2 = iF;
+            A.child2 = iG;
+            G.parent = iA;
+            A.fat = AABB::Combine(B.fat, G.fat);
+            C.fat = AABB::Combine(A.fat, F.fat);
+            A.height = 1 + std::max(B.height, G.height);
+            C.height = 1 + std::max(A.height, F.height);
+        } else {
+            C.child2 = iG;
+            A.child2 = iF;
+            F.parent = iA;
+            A.fat = AABB::Combine(B.fat, F.fat);
+            C.fat = AABB::Combine(A.fat, G.fat);
+            A.height = 1 + std::max(B.height, F.height);
+            C.height = 1 + std::max(A.height, G.height);
+        }
+
+        return iC;
+    }
+
+    // Rotate B up
+    if (balance < -1) {
+        int32_t iD = B.child1;
+        int32_t iE = B.child2;
+        Node& D = nodes[iD];
+        Node& E = nodes[iE];
+
+        // Swap A and B
+        B.child1 = iA;
+        B.parent = A.parent;
+        A.parent = iB;
+
+        // A's old parent should point to B
+        if (B.parent != NULL_NODE) {
+            if (nodes[B.parent].child1 == iA) {
+                nodes[B.parent].child1 = iB;
+            } else {
+                nodes[B.parent].child2 = iB;
+            }
+        } else {
+            root = iB;
+        }
+
+        // Rotate
+        if (D.height > E.height) {
+            B.child2 = iD;
+            A.child1 = iE;
+            E.parent = iA;
+            A.fat = AABB::Combine(C.fat, E.fat);
+            B.fat = AABB::Combine(A.fat, D.fat);
+            A.height = 1 + std::max(C.height, E.height);
+            B.height = 1 + std::max(A.height, D.height);
+        } else {
+            B.child2 = iE;
+            A.child1 = iD;
+            D.parent = iA;
+            A.fat = AABB::Combine(C.fat, D.fat);
+            B.fat = AABB::Combine(A.fat, E.fat);
+            A.height = 1 + std::max(C.height, D.height);
+            B.height = 1 + std::max(A.height, E.height);
+        }
+
+        return iB;
+    }
+
+    return iA;
+}
+
+AABB DynamicAABBTree::Fatten(const AABB& bounds) const {
+    AABB fat;
+    fat.minX = bounds.minX - fatMargin;
+    fat.minY = bounds.minY - fatMargin;
+    fat.maxX = bounds.maxX + fatMargin;
+    fat.maxY = bounds.maxY + fatMargin;
+    return fat;
+}
+
+}
@@ -0,0 +1,106 @@
+#ifndef DYNAMICAABBTREE_H
+#define DYNAMICAABBTREE_H
+
+#include "AABB.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace RiverCore {
+
+// Incrementally maintained bounding volume hierarchy used as a collision broadphase and for spatial queries
+// Each proxy stores a fat AABB (tight bounds grown by a margin) in the tree; a proxy is only reinserted when its
+// tight bounds leave the fat AABB, so resting and static bodies are never reinserted. Internal nodes are kept
+// balanced with AVL-style rotations, which suits worlds mixing very large and very small colliders.
+class DynamicAABBTree {
+public:
+    // Index used for "no node"
+    static constexpr int32_t NULL_NODE = -1;
+
+    DynamicAABBTree() = default;
+    ~DynamicAABBTree() = default;
+
+    // Function to set the margin used to fatten proxy bounds (world units)
+    void SetMargin(float margin);
+    // Function to get the margin used to fatten proxy bounds
+    float GetMargin() const { return fatMargin; }
+
+    // Creates a proxy for an entity (index is the entity's current dense index), returns the proxy ID
+    int32_t CreateProxy(const AABB& bounds, uint32_t entityID, uint32_t index);
+    // Destroys a proxy
+    void DestroyProxy(int32_t proxyID);
+    // Updates a proxy's tight bounds, reinserting it only if they left its fat AABB (returns whether it was reinserted)
+    bool MoveProxy(int32_t proxyID, const AABB& bounds);
+    // Removes every proxy
+    void Clear();
+
+    // Sets the dense index stored in a proxy
+    void SetIndex(int32_t proxyID, uint32_t index) { nodes[proxyID].index = index; }
+    // Gets the dense index stored in a proxy
+    uint32_t GetIndex(int32_t proxyID) const { return nodes[proxyID].index; }
+    // Gets the entity ID stored in a proxy
+    uint32_t GetEntityID(int32_t proxyID) const { return nodes[proxyID].entityID; }
+    // Gets the tight bounds of a proxy
+    const AABB& GetBounds(int32_t proxyID) const { return nodes[proxyID].tight; }
+    // Gets the fat bounds of a proxy
+    const AABB& GetFatBounds(int32_t proxyID) const { return nodes[proxyID].fat; }
+
+    // Collects the proxies whose fat AABB overlaps the bounds (candidates, not exact hits)
+    void Query(const AABB& bounds, std::vector<int32_t>& proxies) const;
+    // Same as Query, using a caller-owned traversal stack so several threads may query at once
+    void Query(const AABB& bounds, std::vector<int32_t>& proxies, std::vector<int32_t>& traversalStack) const;
+    // Casts a ray (normalized direction) against the tight bounds of every proxy, reporting the closest hit
+    bool Raycast(const Vec2& origin, const Vec2& direction, float maxDistance, RaycastHit& hit) const;
+
+    // Returns the number of proxies
+    size_t GetProxyCount() const { return proxyCount; }
+    // Returns the height of the tree (0 when empty)
+    int32_t GetHeight() const { return root == NULL_NODE ? 0 : nodes[root].height; }
+
+private:
+    // Tree node (leaves are proxies)
+    struct Node {
+        AABB fat;                      // Bounds used by the tree (enlarged for leaves)
+        AABB tight;                    // Exact bounds (leaves only)
+        uint32_t entityID = 0;
+        uint32_t index = 0;
+        int32_t parent = NULL_NODE;    // Next free node while on the free list
+        int32_t child1 = NULL_NODE;
+        int32_t child2 = NULL_NODE;
+        int32_t height = -1;           // 0 for leaves, -1 for free nodes
+
+        bool IsLeaf() const { return child1 == NULL_NODE; }
+    };
+
+    // Node pool
+    std::vector<Node> nodes;
+    // Root node
+    int32_t root = NULL_NODE;
+    // Head of the free node list
+    int32_t freeList = NULL_NODE;
+    // Number of live proxies
+    size_t proxyCount = 0;
+    // Margin added around tight bounds
+    float fatMargin = 16.0f;
+    // Traversal stack for single-threaded queries (kept to reuse its capacity)
+    mutable std::vector<int32_t> stack;
+
+    // Takes a node from the free list (growing the pool if needed)
+    int32_t AllocateNode();
+    // Returns a node to the free list
+    void FreeNode(int32_t nodeID);
+    // Inserts a leaf, choosing the sibling with the lowest perimeter cost
+    void InsertLeaf(int32_t leaf);
+    // Removes a leaf, collapsing its parent
+    void RemoveLeaf(int32_t leaf);
+    // Rotates the subtree at a node if it is unbalanced, returns the new subtree root
+    int32_t Balance(int32_t nodeID);
+    // Refits bounds and heights from a node up to the root, balancing on the way
+    void Refit(int32_t nodeID);
+    // Grows tight bounds by the margin
+    AABB Fatten(const AABB& bounds) const;
+};
+
+}
+
+#endif
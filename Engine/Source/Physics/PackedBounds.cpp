@@ -0,0 +1,93 @@
+#include "PackedBounds.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RIVER_PACKED_BOUNDS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace RiverCore {
+
+namespace {
+
+// Appends the candidates flagged in a lane mask, lowest lane first so the candidate order is kept
+inline size_t AppendHits(unsigned int mask, const uint32_t* candidates, uint32_t* hits, size_t hitCount) {
+    for (unsigned int lane = 0; mask != 0; ++lane, mask >>= 1) {
+        if (mask & 1u) {
+            hits[hitCount++] = candidates[lane];
+        }
+    }
+    return hitCount;
+}
+
+}
+
+void PackedBounds::Resize(size_t count) {
+    minX.resize(count);
+    minY.resize(count);
+    maxX.resize(count);
+    maxY.resize(count);
+}
+
+size_t PackedBounds::CollectOverlaps(const AABB& box, const uint32_t* candidates, size_t count, uint32_t* hits) const {
+    size_t hitCount = 0;
+    size_t k = 0;
+
+#if defined(__AVX2__)
+    // Eight candidates per iteration, gathered straight from the edge arrays
+    const __m256 boxMinX = _mm256_set1_ps(box.minX);
+    const __m256 boxMinY = _mm256_set1_ps(box.minY);
+    const __m256 boxMaxX = _mm256_set1_ps(box.maxX);
+    const __m256 boxMaxY = _mm256_set1_ps(box.maxY);
+    for (; k + 8 <= count; k += 8) {
+        const __m256i indices = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(candidates + k));
+        const __m256 otherMinX = _mm256_i32gather_ps(minX.data(), indices, 4);
+        const __m256 otherMinY = _mm256_i32gather_ps(minY.data(), indices, 4);
+        const __m256 otherMaxX = _mm256_i32gather_ps(maxX.data(), indices, 4);
+        const __m256 otherMaxY = _mm256_i32gather_ps(maxY.data(), indices, 4);
+
+        __m256 overlap = _mm256_cmp_ps(boxMinX, otherMaxX, _CMP_LT_OQ);
+        overlap = _mm256_and_ps(overlap, _mm256_cmp_ps(boxMaxX, otherMinX, _CMP_GT_OQ));
+        overlap = _mm256_and_ps(overlap, _mm256_cmp_ps(boxMinY, otherMaxY, _CMP_LT_OQ));
+        overlap = _mm256_and_ps(overlap, _mm256_cmp_ps(boxMaxY, otherMinY, _CMP_GT_OQ));
+
+        hitCount = AppendHits(static_cast<unsigned int>(_mm256_movemask_ps(overlap)), candidates + k, hits, hitCount);
+    }
+#elif defined(RIVER_PACKED_BOUNDS_SSE2)
+    // Four candidates per iteration (SSE2 has no gather, so the lanes are loaded one by one)
+    const __m128 boxMinX = _mm_set1_ps(box.minX);
+    const __m128 boxMinY = _mm_set1_ps(box.minY);
+    const __m128 boxMaxX = _mm_set1_ps(box.maxX);
+    const __m128 boxMaxY = _mm_set1_ps(box.maxY);
+    for (; k + 4 <= count; k += 4) {
+        const uint32_t c0 = candidates[k];
+        const uint32_t c1 = candidates[k + 1];
+        const uint32_t c2 = candidates[k + 2];
+        const uint32_t c3 = candidates[k + 3];
+        const __m128 otherMinX = _mm_set_ps(minX[c3], minX[c2], minX[c1], minX[c0]);
+        const __m128 otherMinY = _mm_set_ps(minY[c3], minY[c2], minY[c1], minY[c0]);
+        const __m128 otherMaxX = _mm_set_ps(maxX[c3], maxX[c2], maxX[c1], maxX[c0]);
+        const __m128 otherMaxY = _mm_set_ps(maxY[c3], maxY[c2], maxY[c1], maxY[c0]);
+
+        __m128 overlap = _mm_cmplt_ps(boxMinX, otherMaxX);
+        overlap = _mm_and_ps(overlap, _mm_cmpgt_ps(boxMaxX, otherMinX));
+        overlap = _mm_and_ps(overlap, _mm_cmplt_ps(boxMinY, otherMaxY));
+        overlap = _mm_and_ps(overlap, _mm_cmpgt_ps(boxMaxY, otherMinY));
+
+        hitCount = AppendHits(static_cast<unsigned int>(_mm_movemask_ps(overlap)), candidates + k, hits, hitCount);
+    }
+#endif
+
+    // Scalar fallback and remainder
+    for (; k < count; ++k) {
+        const uint32_t index = candidates[k];
+        if (box.minX < maxX[index] && box.maxX > minX[index] && box.minY < maxY[index] && box.maxY > minY[index]) {
+            hits[hitCount++] = index;
+        }
+    }
+
+    return hitCount;
+}
+
+}
@@ -0,0 +1,50 @@
+#ifndef PACKEDBOUNDS_H
+#define PACKEDBOUNDS_H
+
+#include "AABB.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace RiverCore {
+
+// Collision bounds stored as four packed float arrays (one per edge), indexed by dense entity index
+// Keeping each edge contiguous lets one box be tested against several candidates per SIMD instruction
+// (8 with AVX2, 4 with SSE2, one at a time otherwise)
+struct PackedBounds {
+    std::vector<float> minX;
+    std::vector<float> minY;
+    std::vector<float> maxX;
+    std::vector<float> maxY;
+
+    // Returns the number of stored boxes
+    size_t Size() const { return minX.size(); }
+    // Resizes every edge array
+    void Resize(size_t count);
+
+    // Stores the box at an index
+    void Set(size_t index, const AABB& bounds) {
+        minX[index] = bounds.minX;
+        minY[index] = bounds.minY;
+        maxX[index] = bounds.maxX;
+        maxY[index] = bounds.maxY;
+    }
+
+    // Loads the box at an index
+    AABB Get(size_t index) const {
+        AABB bounds;
+        bounds.minX = minX[index];
+        bounds.minY = minY[index];
+        bounds.maxX = maxX[index];
+        bounds.maxY = maxY[index];
+        return bounds;
+    }
+
+    // Writes the candidates whose box overlaps the given box to hits, keeping their order (same test as AABB::Overlaps)
+    // hits must have room for count entries; returns the number of hits
+    size_t CollectOverlaps(const AABB& box, const uint32_t* candidates, size_t count, uint32_t* hits) const;
+};
+
+}
+
+#endif
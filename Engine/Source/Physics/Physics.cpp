@@ -1,164 +1,546 @@
 #include "Physics.h"
+#include "Renderer/EntitySlotMap.h"
+#include <algorithm>
+#include <cmath>
 
 namespace RiverCore {
 
-void Physics::UpdatePhysics(std::vector<Entity>& entities, float fixedDeltaTime) {
+namespace {
+
+// Minimum loop chunk per worker (smaller loops are not worth waking the workers for)
+constexpr size_t INTEGRATION_CHUNK_SIZE = 256;
+constexpr size_t PAIR_CHUNK_SIZE = 64;
+
+// Margin added around the bounds pairs are gathered with (world units)
+// Entities pushed by less than this during resolution keep their gathered pairs
+constexpr float PAIR_MARGIN = 4.0f;
+
+}
+
+void Physics::UpdatePhysics(EntityStorage& storage, float fixedDeltaTime) {
+    // Bodies integrate independently, so the loop is split across workers
+    ParallelFor(storage.Size(), INTEGRATION_CHUNK_SIZE, [&](size_t begin, size_t end, size_t) {
+        IntegrateBodies(storage, begin, end, fixedDeltaTime);
+    });
+
+    // Update collisions for all entities
+    UpdateCollisions(storage);
+}
+
+void Physics::IntegrateBody(Entity& entity, float fixedDeltaTime) const {
+    ApplyGravity(entity.acceleration, entity.mass);
+    ApplyDrag(entity.acceleration, entity.velocity, entity.mass, entity.drag);
+    IntegrateVelocity(entity.position, entity.velocity, entity.acceleration, fixedDeltaTime);
+}
+
+void Physics::SetWorkerCount(size_t workerCount) {
+    std::lock_guard<std::mutex> lock(broadphaseMutex);
+
+    workerCount = std::max<size_t>(workerCount, 1);
+    if (workerCount == GetWorkerCount()) {
+        return;
+    }
+
+    workerPool.reset();
+    if (workerCount > 1) {
+        workerPool = std::make_unique<WorkerPool>(workerCount);
+    }
+    workerScratch.resize(workerCount);
+}
+
+void Physics::UpdateCollisions(EntityStorage& storage) {
+    const size_t count = storage.Size();
+    const std::vector<ColliderType>& types = storage.collider.type;
+    const std::vector<uint8_t>& enabled = storage.collider.enabled;
+
+    // Spatial queries wait for the step to finish
+    std::lock_guard<std::mutex> lock(broadphaseMutex);
+
+    // Clear all collision data
+    for (ContactList& contactList : storage.contacts) {
+        contactList.clear();
+    }
+
+    // Bounds and sizes only change when collision resolution pushes an entity, so compute them once per step
+    stepBounds.Resize(count);
+    stepSizes.resize(count);
+    ParallelFor(count, INTEGRATION_CHUNK_SIZE, [&](size_t begin, size_t end, size_t) {
+        ComputeStepBounds(storage, begin, end);
+    });
+
+    // Insert every collidable entity into the broadphase
+    BuildBroadphase(storage);
+
+    // With workers, gather the pairs (i, j > i) whose grown bounds overlap at the start of the step in parallel.
+    // Without them, each entity queries the broadphase when its turn comes
+    const bool gatherPairs = workerPool != nullptr;
+    if (pairLists.size() < count) {
+        pairLists.resize(count);
+    }
+    if (gatherPairs) {
+        pairListDirty.assign(count, 0);
+        pairBounds.Resize(count);
+        ParallelFor(count, PAIR_CHUNK_SIZE, [&](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; ++i) {
+                pairBounds.Set(i, stepBounds.Get(i).Expanded(PAIR_MARGIN));
+            }
+        });
+        ParallelFor(count, PAIR_CHUNK_SIZE, [&](size_t begin, size_t end, size_t workerIndex) {
+            FindPairs(storage, begin, end, workerScratch[workerIndex]);
+        });
+    }
+
+    // Resolve the pairs on this thread in the same order as an all-pairs loop, so contacts and pushes are
+    // identical for every worker count. An entity pushed out of its grown bounds gathers its pairs again
+    BroadphaseScratch& scratch = workerScratch[0];
+    std::vector<uint32_t>& hits = pairHits;
+    for (size_t i = 0; i < count; ++i) {
+        // Skip if this entity has no collision
+        if (types[i] == ColliderType::NONE || !enabled[i]) {
+            continue;
+        }
+
+        // Bounds of A only change when A itself is pushed out of another entity
+        AABB a = stepBounds.Get(i);
+
+        std::vector<uint32_t>& pairs = pairLists[i];
+        if (!gatherPairs) {
+            QueryBroadphase(a, static_cast<uint32_t>(i), pairs, scratch);
+        } else if (pairListDirty[i]) {
+            std::sort(pairs.begin(), pairs.end());
+            pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+        }
+
+        // Test A against every candidate at once. Resolving a pair only moves A or the candidate being
+        // resolved, so the remaining results stay valid until A moves
+        hits.resize(pairs.size());
+        size_t hitCount = stepBounds.CollectOverlaps(a, pairs.data(), pairs.size(), hits.data());
+
+        for (size_t k = 0; k < hitCount; ++k) {
+            size_t j = hits[k];
+
+            PairResult result = ResolvePair(storage, i, j, a, stepBounds.Get(j));
+            if (result == PairResult::MovedA) {
+                a = ComputeBounds(storage, i);
+                stepBounds.Set(i, a);
+                UpdateBroadphase(static_cast<uint32_t>(i), a);
+
+                // A moved, so the remaining candidates come from its new bounds
+                QueryBroadphase(a, static_cast<uint32_t>(j), pairs, scratch);
+                hits.resize(pairs.size());
+                hitCount = stepBounds.CollectOverlaps(a, pairs.data(), pairs.size(), hits.data());
+                k = static_cast<size_t>(-1);
+            } else if (result == PairResult::MovedB) {
+                // Keep B at its new position in the broadphase and the pair lists for the pairs it forms later
+                AABB b = ComputeBounds(storage, j);
+                stepBounds.Set(j, b);
+                UpdateBroadphase(static_cast<uint32_t>(j), b);
+                if (gatherPairs && !pairBounds.Get(j).Contains(b)) {
+                    pairBounds.Set(j, b.Expanded(PAIR_MARGIN));
+                    AddMovedPairs(i, j, scratch);
+                }
+            }
+        }
+    }
+
+    // Keep the final bounds of this step for spatial queries
+    FinishBroadphase(storage);
+
+    // Turn contact changes since the last step into collision events
+    contactTable.Update(storage);
+}
+
+void Physics::ParallelFor(size_t count, size_t minChunkSize, const WorkerPool::RangeTask& task) {
+    if (workerPool) {
+        workerPool->ParallelFor(count, minChunkSize, task);
+    } else if (count > 0) {
+        task(0, count, 0);
+    }
+}
+
+void Physics::IntegrateBodies(EntityStorage& storage, size_t begin, size_t end, float fixedDeltaTime) const {
+    TransformColumns& transform = storage.transform;
+    BodyColumns& body = storage.body;
+
     // Update physics for all entities that have physics enabled
-    for (Entity& entity : entities) {
-        if (entity.physApplied) {
+    for (size_t i = begin; i < end; ++i) {
+        if (body.physApplied[i]) {
             // Apply gravity
-            ApplyGravity(entity);
+            ApplyGravity(body.acceleration[i], body.mass[i]);
 
             // Apply drag
-            ApplyDrag(entity);
+            ApplyDrag(body.acceleration[i], body.velocity[i], body.mass[i], body.drag[i]);
 
             // Integrate velocity into position
-            IntegrateVelocity(entity, fixedDeltaTime);
+            IntegrateVelocity(transform.position[i], body.velocity[i], body.acceleration[i], fixedDeltaTime);
         }
     }
+}
 
-    // Update collisions for all entities
-    UpdateCollisions(entities);
+void Physics::ComputeStepBounds(const EntityStorage& storage, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        stepSizes[i] = ComputeSize(storage, i);
+        stepBounds.Set(i, ComputeBounds(storage, i));
+    }
 }
 
-void Physics::UpdateCollisions(std::vector<Entity>& entities) {
-    // Clear all collision data
-    for (Entity& entity : entities) {
-        entity.collider.ClearCollisions();
+void Physics::FindPairs(const EntityStorage& storage, size_t begin, size_t end, BroadphaseScratch& scratch) {
+    for (size_t i = begin; i < end; ++i) {
+        std::vector<uint32_t>& pairs = pairLists[i];
+        pairs.clear();
+
+        if (storage.collider.type[i] == ColliderType::NONE || !storage.collider.enabled[i]) {
+            continue;
+        }
+
+        // Entities stay inside their grown bounds until pushed out of them, so any pair that can
+        // overlap during resolution has overlapping grown bounds
+        AABB a = pairBounds.Get(i);
+        QueryBroadphase(a.Expanded(PAIR_MARGIN), static_cast<uint32_t>(i), scratch.candidates, scratch);
+        pairs.resize(scratch.candidates.size());
+        pairs.resize(pairBounds.CollectOverlaps(a, scratch.candidates.data(), scratch.candidates.size(), pairs.data()));
     }
+}
 
-    // Check collisions between all entity pairs
-    for (size_t i = 0; i < entities.size(); ++i) {
-        Entity& entityA = entities[i];
+void Physics::AddMovedPairs(size_t i, size_t j, BroadphaseScratch& scratch) {
+    // Pairs with entities up to i were already resolved, and pair (i, j) is being resolved now
+    AABB b = pairBounds.Get(j);
+    QueryBroadphase(b.Expanded(PAIR_MARGIN), static_cast<uint32_t>(i), scratch.candidates, scratch);
+    scratch.hits.resize(scratch.candidates.size());
+    size_t hitCount = pairBounds.CollectOverlaps(b, scratch.candidates.data(), scratch.candidates.size(), scratch.hits.data());
+
+    for (size_t n = 0; n < hitCount; ++n) {
+        uint32_t k = scratch.hits[n];
+        if (k == j) {
+            continue;
+        }
 
-        for (size_t j = i + 1; j < entities.size(); ++j) {
-            Entity& entityB = entities[j];
+        // Each pair is listed under its lower index
+        size_t owner = std::min<size_t>(k, j);
+        pairLists[owner].push_back(static_cast<uint32_t>(std::max<size_t>(k, j)));
+        pairListDirty[owner] = 1;
+    }
+}
 
-            // Skip if either entity has no collision
-            if (entityA.collider.type == ColliderType::NONE ||
-                entityB.collider.type == ColliderType::NONE ||
-                !entityA.collider.enabled || !entityB.collider.enabled) {
-                continue;
-            }
+Physics::PairResult Physics::ResolvePair(EntityStorage& storage, size_t i, size_t j, const AABB& a, const AABB& b) const {
+    const std::vector<uint32_t>& ids = storage.ids;
+    std::vector<Vec2>& positions = storage.transform.position;
+    std::vector<Vec2>& velocities = storage.body.velocity;
+    const std::vector<uint8_t>& physApplied = storage.body.physApplied;
+    const std::vector<ColliderType>& types = storage.collider.type;
+    std::vector<ContactList>& contacts = storage.contacts;
+
+    // Determine collision sides
+    const Vec2& aSize = stepSizes[i];
+    float aWidth = aSize.x;
+    float aHeight = aSize.y;
+    const Vec2& bSize = stepSizes[j];
+    float bWidth = bSize.x;
+    float bHeight = bSize.y;
+
+    // Check collision sides for entity A
+    if (b.minY >= a.minY && b.minY <= a.maxY) {
+        contacts[i].push_back({ids[j], 0}); // top
+    }
+    if (b.maxX >= a.minX && b.maxX <= a.maxX) {
+        contacts[i].push_back({ids[j], 1}); // right
+    }
+    if (b.maxY >= a.minY && b.maxY <= a.maxY) {
+        contacts[i].push_back({ids[j], 2}); // bottom
+    }
+    if (b.minX >= a.minX && b.minX <= a.maxX) {
+        contacts[i].push_back({ids[j], 3}); // left
+    }
 
-            if (CheckAABBCollision(entityA, entityB)) {
-                // Determine collision sides
-                float aFrameWidth = entityA.totalFrames > 1 ? (entityA.spriteWidth / 
-                    static_cast<float>(entityA.totalFrames)) : entityA.spriteWidth;
-                float bFrameWidth = entityB.totalFrames > 1 ? (entityB.spriteWidth / 
-                    static_cast<float>(entityB.totalFrames)) : entityB.spriteWidth;
-
-                float aWidth = aFrameWidth * abs(entityA.scale.x);
-                float aHeight = entityA.spriteHeight * abs(entityA.scale.y);
-                float bWidth = bFrameWidth * abs(entityB.scale.x);
-                float bHeight = entityB.spriteHeight * abs(entityB.scale.y);
-
-                float ax1 = entityA.position.x - (aWidth / 2.0f);
-                float ax2 = entityA.position.x + (aWidth / 2.0f);
-                float ay1 = entityA.position.y - (aHeight / 2.0f);
-                float ay2 = entityA.position.y + (aHeight / 2.0f);
-
-                float bx1 = entityB.position.x - (bWidth / 2.0f);
-                float bx2 = entityB.position.x + (bWidth / 2.0f);
-                float by1 = entityB.position.y - (bHeight / 2.0f);
-                float by2 = entityB.position.y + (bHeight / 2.0f);
-
-                // Check collision sides for entity A
-                if (by1 >= ay1 && by1 <= ay2) {
-                    entityA.collider.AddCollision(entityB.ID, 0); // top
-                }
-                if (bx2 >= ax1 && bx2 <= ax2) {
-                    entityA.collider.AddCollision(entityB.ID, 1); // right
-                }
-                if (by2 >= ay1 && by2 <= ay2) {
-                    entityA.collider.AddCollision(entityB.ID, 2); // bottom
-                }
-                if (bx1 >= ax1 && bx1 <= ax2) {
-                    entityA.collider.AddCollision(entityB.ID, 3); // left
-                }
+    // Check collision sides for entity B (opposite directions)
+    if (a.minY >= b.minY && a.minY <= b.maxY) {
+        contacts[j].push_back({ids[i], 0}); // top
+    }
+    if (a.maxX >= b.minX && a.maxX <= b.maxX) {
+        contacts[j].push_back({ids[i], 1}); // right
+    }
+    if (a.maxY >= b.minY && a.maxY <= b.maxY) {
+        contacts[j].push_back({ids[i], 2}); // bottom
+    }
+    if (a.minX >= b.minX && a.minX <= b.maxX) {
+        contacts[j].push_back({ids[i], 3}); // left
+    }
 
-                // Check collision sides for entity B (opposite directions)
-                if (ay1 >= by1 && ay1 <= by2) {
-                    entityB.collider.AddCollision(entityA.ID, 0); // top
+    // Only resolve position if both entities are SOLID colliders
+    if (types[i] == ColliderType::SOLID && types[j] == ColliderType::SOLID) {
+        // Calculate overlap
+        float overlapX = std::min(a.maxX, b.maxX) - std::max(a.minX, b.minX);
+        float overlapY = std::min(a.maxY, b.maxY) - std::max(a.minY, b.minY);
+
+        // Case 1: A is dynamic, B is static
+        if (physApplied[i] && !physApplied[j]) {
+            // Resolve collision by moving A out of B along the smallest overlap
+            if (overlapX < overlapY) {
+                // Horizontal separation
+                if (positions[i].x < positions[j].x) {
+                    positions[i].x = b.minX - (aWidth / 2.0f); // Push left
+                    velocities[i].x = std::min(0.0f, velocities[i].x);
+                } else {
+                    positions[i].x = b.maxX + (aWidth / 2.0f); // Push right
+                    velocities[i].x = std::max(0.0f, velocities[i].x);
                 }
-                if (ax2 >= bx1 && ax2 <= bx2) {
-                    entityB.collider.AddCollision(entityA.ID, 1); // right
+            } else {
+                // Vertical separation
+                if (positions[i].y < positions[j].y) {
+                    positions[i].y = b.minY - (aHeight / 2.0f); // Push up (A above B)
+                    velocities[i].y = std::min(0.0f, velocities[i].y);
+                } else {
+                    positions[i].y = b.maxY + (aHeight / 2.0f); // Push down (A below B)
+                    velocities[i].y = std::max(0.0f, velocities[i].y);
                 }
-                if (ay2 >= by1 && ay2 <= by2) {
-                    entityB.collider.AddCollision(entityA.ID, 2); // bottom
+            }
+            return PairResult::MovedA;
+        }
+        // Case 2: A is static, B is dynamic
+        else if (!physApplied[i] && physApplied[j]) {
+            // Resolve collision by moving B out of A along the smallest overlap
+            if (overlapX < overlapY) {
+                // Horizontal separation
+                if (positions[j].x < positions[i].x) {
+                    positions[j].x = a.minX - (bWidth / 2.0f); // Push left
+                    velocities[j].x = std::min(0.0f, velocities[j].x);
+                } else {
+                    positions[j].x = a.maxX + (bWidth / 2.0f); // Push right
+                    velocities[j].x = std::max(0.0f, velocities[j].x);
                 }
-                if (ax1 >= bx1 && ax1 <= bx2) {
-                    entityB.collider.AddCollision(entityA.ID, 3); // left
+            } else {
+                // Vertical separation
+                if (positions[j].y < positions[i].y) {
+                    positions[j].y = a.minY - (bHeight / 2.0f); // Push up (B above A)
+                    velocities[j].y = std::min(0.0f, velocities[j].y);
+                } else {
+                    positions[j].y = a.maxY + (bHeight / 2.0f); // Push down (B below A)
+                    velocities[j].y = std::max(0.0f, velocities[j].y);
                 }
+            }
+            return PairResult::MovedB;
+        }
+    }
 
-                // Only resolve position if both entities are SOLID colliders
-                if (entityA.collider.type == ColliderType::SOLID &&
-                    entityB.collider.type == ColliderType::SOLID) {
-
-                    // Calculate overlap
-                    float overlapX = std::min(ax2, bx2) - std::max(ax1, bx1);
-                    float overlapY = std::min(ay2, by2) - std::max(ay1, by1);
-
-                    // Case 1: A is dynamic, B is static
-                    if (entityA.physApplied && !entityB.physApplied) {
-                        // Resolve collision by moving A out of B along the smallest overlap
-                        if (overlapX < overlapY) {
-                            // Horizontal separation
-                            if (entityA.position.x < entityB.position.x) {
-                                entityA.position.x = bx1 - (aWidth / 2.0f); // Push left
-                                entityA.velocity.x = std::min(0.0f, entityA.velocity.x);
-                            } else {
-                                entityA.position.x = bx2 + (aWidth / 2.0f); // Push right
-                                entityA.velocity.x = std::max(0.0f, entityA.velocity.x);
-                            }
-                        } else {
-                            // Vertical separation
-                            if (entityA.position.y < entityB.position.y) {
-                                entityA.position.y = by1 - (aHeight / 2.0f); // Push up (A above B)
-                                entityA.velocity.y = std::min(0.0f, entityA.velocity.y);
-                            } else {
-                                entityA.position.y = by2 + (aHeight / 2.0f); // Push down (A below B)
-                                entityA.velocity.y = std::max(0.0f, entityA.velocity.y);
-                            }
-                        }
-                    }
-                    // Case 2: A is static, B is dynamic
-                    else if (!entityA.physApplied && entityB.physApplied) {
-                        // Resolve collision by moving B out of A along the smallest overlap
-                        if (overlapX < overlapY) {
-                            // Horizontal separation
-                            if (entityB.position.x < entityA.position.x) {
-                                entityB.position.x = ax1 - (bWidth / 2.0f); // Push left
-                                entityB.velocity.x = std::min(0.0f, entityB.velocity.x);
-                            } else {
-                                entityB.position.x = ax2 + (bWidth / 2.0f); // Push right
-                                entityB.velocity.x = std::max(0.0f, entityB.velocity.x);
-                            }
-                        } else {
-                            // Vertical separation
-                            if (entityB.position.y < entityA.position.y) {
-                                entityB.position.y = ay1 - (bHeight / 2.0f); // Push up (B above A)
-                                entityB.velocity.y = std::min(0.0f, entityB.velocity.y);
-                            } else {
-                                entityB.position.y = ay2 + (bHeight / 2.0f); // Push down (B below A)
-                                entityB.velocity.y = std::max(0.0f, entityB.velocity.y);
-                            }
-                        }
-                    }
-                }
+    return PairResult::None;
+}
+
+Vec2 Physics::ComputeSize(const EntityStorage& storage, size_t index) {
+    const Vec2& scale = storage.transform.scale[index];
+    const Vec2& frameSize = storage.collider.frameSize[index];
+    return Vec2(frameSize.x * std::abs(scale.x), frameSize.y * std::abs(scale.y));
+}
+
+AABB Physics::ComputeBounds(const EntityStorage& storage, size_t index) {
+    const Vec2& position = storage.transform.position[index];
+    Vec2 size = ComputeSize(storage, index);
+
+    AABB bounds;
+    bounds.minX = position.x - (size.x / 2.0f);
+    bounds.maxX = position.x + (size.x / 2.0f);
+    bounds.minY = position.y - (size.y / 2.0f);
+    bounds.maxY = position.y + (size.y / 2.0f);
+    return bounds;
+}
+
+void Physics::SetBroadphaseType(BroadphaseType type) {
+    std::lock_guard<std::mutex> lock(broadphaseMutex);
+    if (type == broadphaseType) {
+        return;
+    }
+
+    broadphaseType = type;
+
+    // The tree is rebuilt from scratch if it is selected again later
+    broadphaseTree.Clear();
+    proxyBySlot.clear();
+    proxyStamps.clear();
+    queryIDs.clear();
+    queryBounds.clear();
+}
+
+void Physics::SetBroadphaseMargin(float margin) {
+    std::lock_guard<std::mutex> lock(broadphaseMutex);
+    broadphaseTree.SetMargin(margin);
+}
+
+std::vector<uint32_t> Physics::QueryArea(const Vec2& min, const Vec2& max) const {
+    std::lock_guard<std::mutex> lock(broadphaseMutex);
+
+    AABB area;
+    area.minX = std::min(min.x, max.x);
+    area.minY = std::min(min.y, max.y);
+    area.maxX = std::max(min.x, max.x);
+    area.maxY = std::max(min.y, max.y);
+
+    std::vector<uint32_t> entityIDs;
+    if (broadphaseType == BroadphaseType::DynamicTree) {
+        std::vector<int32_t> proxies;
+        broadphaseTree.Query(area, proxies);
+        for (int32_t proxy : proxies) {
+            if (broadphaseTree.GetBounds(proxy).Overlaps(area)) {
+                entityIDs.push_back(broadphaseTree.GetEntityID(proxy));
+            }
+        }
+    } else {
+        for (size_t i = 0; i < queryIDs.size(); ++i) {
+            if (queryBounds[i].Overlaps(area)) {
+                entityIDs.push_back(queryIDs[i]);
             }
         }
     }
+    return entityIDs;
+}
+
+bool Physics::Raycast(const Vec2& origin, const Vec2& direction, float maxDistance, RaycastHit& hit) const {
+    Vec2 unitDirection = direction.normalized();
+    if (unitDirection.x == 0.0f && unitDirection.y == 0.0f) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(broadphaseMutex);
+
+    if (broadphaseType == BroadphaseType::DynamicTree) {
+        return broadphaseTree.Raycast(origin, unitDirection, maxDistance, hit);
+    }
+
+    bool found = false;
+    float closest = maxDistance;
+    for (size_t i = 0; i < queryIDs.size(); ++i) {
+        float distance;
+        Vec2 normal;
+        if (queryBounds[i].Raycast(origin, unitDirection, closest, distance, normal) && (!found || distance < closest)) {
+            found = true;
+            closest = distance;
+            hit.entityID = queryIDs[i];
+            hit.distance = distance;
+            hit.normal = normal;
+            hit.point = origin + unitDirection * distance;
+        }
+    }
+    return found;
+}
+
+void Physics::BuildBroadphase(const EntityStorage& storage) {
+    const size_t count = storage.Size();
+
+    if (broadphaseType == BroadphaseType::DynamicTree) {
+        SyncTree(storage);
+        return;
+    }
+
+    // Bin every collidable entity into the grid
+    broadphaseGrid.Clear(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (storage.collider.type[i] != ColliderType::NONE && storage.collider.enabled[i]) {
+            broadphaseGrid.Insert(static_cast<uint32_t>(i), stepBounds.Get(i));
+        }
+    }
+}
+
+void Physics::QueryBroadphase(const AABB& bounds, uint32_t minIndex, std::vector<uint32_t>& candidates,
+                              BroadphaseScratch& scratch) const {
+    if (broadphaseType == BroadphaseType::SpatialHash) {
+        broadphaseGrid.Query(bounds, minIndex, candidates);
+        return;
+    }
+
+    candidates.clear();
+    broadphaseTree.Query(bounds, scratch.proxies, scratch.stack);
+    for (int32_t proxy : scratch.proxies) {
+        uint32_t index = broadphaseTree.GetIndex(proxy);
+        if (index > minIndex) {
+            candidates.push_back(index);
+        }
+    }
+
+    // Candidates are visited in index order so pair processing matches the all-pairs loop
+    std::sort(candidates.begin(), candidates.end());
+}
+
+void Physics::UpdateBroadphase(uint32_t index, const AABB& bounds) {
+    if (broadphaseType == BroadphaseType::SpatialHash) {
+        broadphaseGrid.Update(index, bounds);
+    } else {
+        broadphaseTree.MoveProxy(proxyByIndex[index], bounds);
+    }
+}
+
+void Physics::FinishBroadphase(const EntityStorage& storage) {
+    // The tree already holds the final tight bounds of every proxy
+    if (broadphaseType == BroadphaseType::DynamicTree) {
+        return;
+    }
+
+    queryIDs.clear();
+    queryBounds.clear();
+    for (size_t i = 0; i < storage.Size(); ++i) {
+        if (storage.collider.type[i] != ColliderType::NONE && storage.collider.enabled[i]) {
+            queryIDs.push_back(storage.ids[i]);
+            queryBounds.push_back(stepBounds.Get(i));
+        }
+    }
+}
+
+void Physics::SyncTree(const EntityStorage& storage) {
+    const size_t count = storage.Size();
+    proxyByIndex.assign(count, DynamicAABBTree::NULL_NODE);
+
+    // Advance the stamp marking proxies seen this step
+    if (++syncStamp == 0) {
+        std::fill(proxyStamps.begin(), proxyStamps.end(), 0);
+        syncStamp = 1;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        if (storage.collider.type[i] == ColliderType::NONE || !storage.collider.enabled[i]) {
+            continue;
+        }
+
+        uint32_t entityID = storage.ids[i];
+        uint32_t slot = EntitySlotMap::GetSlot(entityID);
+        if (slot >= proxyBySlot.size()) {
+            proxyBySlot.resize(slot + 1, DynamicAABBTree::NULL_NODE);
+            proxyStamps.resize(slot + 1, 0);
+        }
+
+        int32_t& proxy = proxyBySlot[slot];
+        // The slot was reused by a new entity since the last step
+        if (proxy != DynamicAABBTree::NULL_NODE && broadphaseTree.GetEntityID(proxy) != entityID) {
+            broadphaseTree.DestroyProxy(proxy);
+            proxy = DynamicAABBTree::NULL_NODE;
+        }
+
+        AABB bounds = stepBounds.Get(i);
+        if (proxy == DynamicAABBTree::NULL_NODE) {
+            proxy = broadphaseTree.CreateProxy(bounds, entityID, static_cast<uint32_t>(i));
+        } else {
+            // Resting and static bodies stay inside their fat AABB, so only their tight bounds are refreshed
+            broadphaseTree.SetIndex(proxy, static_cast<uint32_t>(i));
+            broadphaseTree.MoveProxy(proxy, bounds);
+        }
+
+        proxyByIndex[i] = proxy;
+        proxyStamps[slot] = syncStamp;
+    }
+
+    // Destroy proxies of entities that were removed or stopped colliding
+    for (size_t slot = 0; slot < proxyBySlot.size(); ++slot) {
+        if (proxyBySlot[slot] != DynamicAABBTree::NULL_NODE && proxyStamps[slot] != syncStamp) {
+            broadphaseTree.DestroyProxy(proxyBySlot[slot]);
+            proxyBySlot[slot] = DynamicAABBTree::NULL_NODE;
+        }
+    }
 }
 
 bool Physics::CheckAABBCollision(const Entity& a, const Entity& b) const {
     float aFrameWidth = a.totalFrames > 1 ? (a.spriteWidth / static_cast<float>(a.totalFrames)) : a.spriteWidth;
     float bFrameWidth = b.totalFrames > 1 ? (b.spriteWidth / static_cast<float>(b.totalFrames)) : b.spriteWidth;
 
-    float aWidth = aFrameWidth * abs(a.scale.x);
-    float aHeight = a.spriteHeight * abs(a.scale.y);
-    float bWidth = bFrameWidth * abs(b.scale.x);
-    float bHeight = b.spriteHeight * abs(b.scale.y);
+    float aWidth = aFrameWidth * std::abs(a.scale.x);
+    float aHeight = a.spriteHeight * std::abs(a.scale.y);
+    float bWidth = bFrameWidth * std::abs(b.scale.x);
+    float bHeight = b.spriteHeight * std::abs(b.scale.y);
 
     float ax1 = a.position.x - (aWidth / 2.0f);
     float ax2 = a.position.x + (aWidth / 2.0f);
@@ -174,9 +556,7 @@ bool Physics::CheckAABBCollision(const Entity& a, const Entity& b) const {
 }
 
 void Physics::ApplyForce(Entity& entity, const Vec2& force) {
-    if (entity.mass > 0.0f) {
-        entity.acceleration += force / entity.mass;
-    }
+    AccumulateForce(entity.acceleration, entity.mass, force);
 }
 
 void Physics::ApplyImpulse(Entity& entity, const Vec2& impulse) {
@@ -189,27 +569,33 @@ void Physics::SetVelocity(Entity& entity, const Vec2& velocity) {
     entity.velocity = velocity;
 }
 
-void Physics::ApplyGravity(Entity& entity) {
-    Vec2 gravityForce = GetGravityVector() * entity.mass;
-    ApplyForce(entity, gravityForce);
+void Physics::ApplyGravity(Vec2& acceleration, float mass) const {
+    Vec2 gravityForce = GetGravityVector() * mass;
+    AccumulateForce(acceleration, mass, gravityForce);
 }
 
-void Physics::ApplyDrag(Entity& entity) {
-    if (entity.drag > 0.0f) {
-        Vec2 dragForce = entity.velocity * (-entity.drag);
-        ApplyForce(entity, dragForce);
+void Physics::ApplyDrag(Vec2& acceleration, const Vec2& velocity, float mass, float drag) const {
+    if (drag > 0.0f) {
+        Vec2 dragForce = velocity * (-drag);
+        AccumulateForce(acceleration, mass, dragForce);
     }
 }
 
-void Physics::IntegrateVelocity(Entity& entity, float fixedDeltaTime) {
+void Physics::IntegrateVelocity(Vec2& position, Vec2& velocity, Vec2& acceleration, float fixedDeltaTime) const {
     // Update velocity from acceleration
-    entity.velocity += entity.acceleration * fixedDeltaTime;
+    velocity += acceleration * fixedDeltaTime;
 
     // Update position from velocity
-    entity.position += entity.velocity * fixedDeltaTime;
+    position += velocity * fixedDeltaTime;
 
     // Reset acceleration (forces need to be applied each frame)
-    entity.acceleration = Vec2::zero();
+    acceleration = Vec2::zero();
+}
+
+void Physics::AccumulateForce(Vec2& acceleration, float mass, const Vec2& force) {
+    if (mass > 0.0f) {
+        acceleration += force / mass;
+    }
 }
 
 }
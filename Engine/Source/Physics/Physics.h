@@ -3,10 +3,25 @@
 
 #include "Math/Math.h"
 #include "Renderer/Entity.h"
+#include "Renderer/EntityStorage.h"
+#include "AABB.h"
+#include "SpatialHashGrid.h"
+#include "DynamicAABBTree.h"
+#include "PackedBounds.h"
+#include "ContactTable.h"
+#include "Core/WorkerPool.h"
 #include <vector>
+#include <mutex>
+#include <memory>
 
 namespace RiverCore{
 
+// Broadphase used to find candidate collision pairs
+enum class BroadphaseType {
+    SpatialHash,    // Uniform grid rebuilt every step (colliders of similar size)
+    DynamicTree     // Incrementally maintained AABB tree (very uneven collider sizes, fast spatial queries)
+};
+
 class Physics {
 public:
     Physics() = default;
@@ -19,13 +34,45 @@ public:
     // Function to get gravity vector
     Vec2 GetGravityVector() const { return Vec2(0.0f, gravityAmount); }
 
-    // Function to update physics
-    void UpdatePhysics(std::vector<Entity>& entities, float fixedDeltaTime);
+    // Function to update physics (only the transform, body, collider and contact columns are touched)
+    void UpdatePhysics(EntityStorage& storage, float fixedDeltaTime);
+    // Function to integrate a single body over a fixed time step the way UpdatePhysics does, without collisions
+    // (used to predict an entity outside the storage step, whatever its physApplied flag)
+    void IntegrateBody(Entity& entity, float fixedDeltaTime) const;
+
+    // Function to select the broadphase (per Physics instance)
+    void SetBroadphaseType(BroadphaseType type);
+    // Function to get the selected broadphase
+    BroadphaseType GetBroadphaseType() const { return broadphaseType; }
+    // Function to set the margin added around tree proxies (world units, larger means fewer reinsertions)
+    void SetBroadphaseMargin(float margin);
+    // Function to get the margin added around tree proxies
+    float GetBroadphaseMargin() const { return broadphaseTree.GetMargin(); }
+    // Function to set the broadphase grid cell size (world units, ideally close to a typical collider size)
+    void SetBroadphaseCellSize(float cellSize) { broadphaseGrid.SetCellSize(cellSize); }
+    // Function to get the broadphase grid cell size
+    float GetBroadphaseCellSize() const { return broadphaseGrid.GetCellSize(); }
+
+    // Function to set the number of threads the physics step is split across (1 runs everything on the calling thread)
+    // Results are identical for every worker count
+    void SetWorkerCount(size_t workerCount);
+    // Function to get the number of threads the physics step is split across
+    size_t GetWorkerCount() const { return workerPool ? workerPool->GetWorkerCount() : 1; }
 
     // Function to update collisions
-    void UpdateCollisions(std::vector<Entity>& entities);
+    void UpdateCollisions(EntityStorage& storage);
+    // Thread-safe function to queue the collision begin, stay and end events of the steps run since the last flush
+    void FlushContactEvents(EventManager& eventManager) { contactTable.Flush(eventManager); }
+    // Thread-safe function to find the entities whose collision bounds overlap an area (as of the last step)
+    std::vector<uint32_t> QueryArea(const Vec2& min, const Vec2& max) const;
+    // Thread-safe function to cast a ray against entity collision bounds (as of the last step), reporting the closest hit
+    bool Raycast(const Vec2& origin, const Vec2& direction, float maxDistance, RaycastHit& hit) const;
     // Uses Axis-Aligned Bounding Box (AABB) collision detection to check for collisions between two entities
     bool CheckAABBCollision(const Entity& a, const Entity& b) const;
+    // Computes the scaled collision size of the entity at a dense index
+    static Vec2 ComputeSize(const EntityStorage& storage, size_t index);
+    // Computes the world space bounds of the entity at a dense index
+    static AABB ComputeBounds(const EntityStorage& storage, size_t index);
 
     // Applies a force to an entity
     void ApplyForce(Entity& entity, const Vec2& force);
@@ -38,12 +85,90 @@ private:
     // Gravity constant
     float gravityAmount = -981.0f;
 
-    // Applies gravity to an entity
-    void ApplyGravity(Entity& entity);
-    // Applies drag to an entity
-    void ApplyDrag(Entity& entity);
-    // Updates an entity's position and velocity over a fixed time step
-    void IntegrateVelocity(Entity& entity, float fixedDeltaTime);
+    // Selected broadphase
+    BroadphaseType broadphaseType = BroadphaseType::SpatialHash;
+    // Mutex guarding the broadphase between collision steps and spatial queries
+    mutable std::mutex broadphaseMutex;
+    // Broadphase grid rebuilt every collision step
+    SpatialHashGrid broadphaseGrid;
+    // Broadphase tree kept across steps
+    DynamicAABBTree broadphaseTree;
+    // Tree proxy of each entity, indexed by the entity ID's slot
+    std::vector<int32_t> proxyBySlot;
+    // Tree proxy of each dense index during the current step
+    std::vector<int32_t> proxyByIndex;
+    // Last step each slot's proxy was seen in (stale proxies are destroyed)
+    std::vector<uint32_t> proxyStamps;
+    uint32_t syncStamp = 0;
+    // Per-worker query buffers (kept to reuse their capacity)
+    struct BroadphaseScratch {
+        std::vector<uint32_t> candidates;   // Candidate indices returned by the broadphase
+        std::vector<int32_t> proxies;       // Candidate proxies returned by the tree
+        std::vector<int32_t> stack;         // Tree traversal stack
+        std::vector<uint32_t> hits;         // Candidates that passed the overlap test
+    };
+    std::vector<BroadphaseScratch> workerScratch = std::vector<BroadphaseScratch>(1);
+    // Worker pool (null when the step runs on the calling thread only)
+    std::unique_ptr<WorkerPool> workerPool;
+    // Candidate pairs (j > i) of each dense index, gathered in parallel and resolved in index order
+    std::vector<std::vector<uint32_t>> pairLists;
+    // Pair lists that were appended to during resolution and need sorting again
+    std::vector<uint8_t> pairListDirty;
+    // Grown bounds each entity's pairs were gathered with (the entity stays inside them until pushed out)
+    PackedBounds pairBounds;
+    // Collision bounds and scaled sizes of each dense index during the current step
+    PackedBounds stepBounds;
+    std::vector<Vec2> stepSizes;
+    // Candidates of the entity being resolved that overlap it
+    std::vector<uint32_t> pairHits;
+    // Touching pairs of the last step, diffed after every step into collision events
+    ContactTable contactTable;
+    // Collision bounds at the end of the last step, used for queries when the grid broadphase is selected
+    std::vector<uint32_t> queryIDs;
+    std::vector<AABB> queryBounds;
+
+    // Prepares the selected broadphase for a collision step
+    void BuildBroadphase(const EntityStorage& storage);
+    // Collects candidate indices greater than minIndex whose broadphase bounds overlap the bounds, sorted ascending
+    // Only reads the broadphase, so workers with their own scratch may query at once
+    void QueryBroadphase(const AABB& bounds, uint32_t minIndex, std::vector<uint32_t>& candidates,
+                         BroadphaseScratch& scratch) const;
+    // Moves an entity in the broadphase after collision resolution pushed it
+    void UpdateBroadphase(uint32_t index, const AABB& bounds);
+    // Records the final collision bounds of the step for spatial queries
+    void FinishBroadphase(const EntityStorage& storage);
+    // Brings the tree in sync with the storage (creates, moves and destroys proxies)
+    void SyncTree(const EntityStorage& storage);
+
+    // Outcome of resolving a single pair
+    enum class PairResult {
+        None,       // No contact, or a contact without position correction
+        MovedA,     // The lower index was pushed out
+        MovedB      // The higher index was pushed out
+    };
+
+    // Runs a loop over [0, count) on the worker pool, or inline without one
+    void ParallelFor(size_t count, size_t minChunkSize, const WorkerPool::RangeTask& task);
+    // Integrates the bodies in [begin, end)
+    void IntegrateBodies(EntityStorage& storage, size_t begin, size_t end, float fixedDeltaTime) const;
+    // Computes the collision bounds and sizes of the entities in [begin, end) for the current step
+    void ComputeStepBounds(const EntityStorage& storage, size_t begin, size_t end);
+    // Gathers the overlapping pairs of the entities in [begin, end) into their pair lists
+    void FindPairs(const EntityStorage& storage, size_t begin, size_t end, BroadphaseScratch& scratch);
+    // Adds the pairs a pushed entity j forms at its new grown bounds with entities after i to the pair lists
+    void AddMovedPairs(size_t i, size_t j, BroadphaseScratch& scratch);
+    // Records the contacts of a pair whose bounds overlap and pushes a dynamic body out of a static one
+    PairResult ResolvePair(EntityStorage& storage, size_t i, size_t j, const AABB& a, const AABB& b) const;
+
+    // Applies gravity to a body
+    void ApplyGravity(Vec2& acceleration, float mass) const;
+    // Applies drag to a body
+    void ApplyDrag(Vec2& acceleration, const Vec2& velocity, float mass, float drag) const;
+    // Updates a body's position and velocity over a fixed time step
+    void IntegrateVelocity(Vec2& position, Vec2& velocity, Vec2& acceleration, float fixedDeltaTime) const;
+
+    // Accumulates a force into a body's acceleration
+    static void AccumulateForce(Vec2& acceleration, float mass, const Vec2& force);
 };
 
 }
@@ -0,0 +1,180 @@
+#include "SpatialHashGrid.h"
+#include <algorithm>
+#include <cmath>
+
+namespace RiverCore {
+
+void SpatialHashGrid::SetCellSize(float size) {
+    if (size > 0.0f) {
+        cellSize = size;
+    }
+}
+
+void SpatialHashGrid::Clear(size_t expectedCount) {
+    // Keep roughly two buckets per entry, rounded up to a power of two
+    size_t bucketCount = 64;
+    while (bucketCount < expectedCount * 2) {
+        bucketCount *= 2;
+    }
+
+    // Clearing keeps each bucket's capacity, so steady-state steps do not allocate
+    if (buckets.size() < bucketCount) {
+        buckets.resize(bucketCount);
+    }
+    for (size_t i = 0; i < bucketCount; ++i) {
+        buckets[i].clear();
+    }
+    bucketMask = bucketCount - 1;
+
+    ranges.assign(expectedCount, CellRange());
+    oversized.clear();
+}
+
+void SpatialHashGrid::Insert(uint32_t index, const AABB& bounds) {
+    if (index >= ranges.size()) {
+        ranges.resize(index + 1);
+    }
+
+    CellRange range = ComputeRange(bounds);
+    range.inserted = true;
+    range.oversized = CellCount(range) > MAX_CELLS_PER_ENTRY;
+    ranges[index] = range;
+
+    if (range.oversized) {
+        oversized.push_back(index);
+        return;
+    }
+
+    for (int y = range.minY; y <= range.maxY; ++y) {
+        for (int x = range.minX; x <= range.maxX; ++x) {
+            // Two covered cells may hash to the same bucket, which holds the entry once
+            std::vector<uint32_t>& bucket = buckets[BucketIndex(x, y)];
+            if (bucket.empty() || bucket.back() != index) {
+                bucket.push_back(index);
+            }
+        }
+    }
+}
+
+void SpatialHashGrid::Remove(uint32_t index) {
+    if (index >= ranges.size() || !ranges[index].inserted) {
+        return;
+    }
+
+    CellRange& range = ranges[index];
+    if (range.oversized) {
+        oversized.erase(std::find(oversized.begin(), oversized.end(), index));
+    } else {
+        for (int y = range.minY; y <= range.maxY; ++y) {
+            for (int x = range.minX; x <= range.maxX; ++x) {
+                std::vector<uint32_t>& bucket = buckets[BucketIndex(x, y)];
+                auto it = std::find(bucket.begin(), bucket.end(), index);
+                if (it != bucket.end()) {
+                    *it = bucket.back();
+                    bucket.pop_back();
+                }
+            }
+        }
+    }
+    range.inserted = false;
+}
+
+void SpatialHashGrid::Update(uint32_t index, const AABB& bounds) {
+    if (index < ranges.size() && ranges[index].inserted) {
+        CellRange range = ComputeRange(bounds);
+        const CellRange& current = ranges[index];
+        if (range.minX == current.minX && range.minY == current.minY &&
+            range.maxX == current.maxX && range.maxY == current.maxY) {
+            return; // Still covers the same cells
+        }
+        Remove(index);
+    }
+    Insert(index, bounds);
+}
+
+void SpatialHashGrid::Query(const AABB& bounds, uint32_t minIndex, std::vector<uint32_t>& results) const {
+    QueryFrom(bounds, minIndex + 1, results);
+}
+
+void SpatialHashGrid::Query(const AABB& bounds, std::vector<uint32_t>& results) const {
+    QueryFrom(bounds, 0, results);
+}
+
+void SpatialHashGrid::QueryFrom(const AABB& bounds, uint32_t firstIndex, std::vector<uint32_t>& results) const {
+    results.clear();
+
+    CellRange range = ComputeRange(bounds);
+
+    if (CellCount(range) > MAX_CELLS_PER_ENTRY) {
+        // The query covers too many cells to walk, so test cell ranges of every later entry instead
+        for (uint32_t index = firstIndex; index < ranges.size(); ++index) {
+            const CellRange& other = ranges[index];
+            if (other.inserted && other.minX <= range.maxX && other.maxX >= range.minX &&
+                other.minY <= range.maxY && other.maxY >= range.minY) {
+                results.push_back(index);
+            }
+        }
+        return;
+    }
+
+    for (int y = range.minY; y <= range.maxY; ++y) {
+        for (int x = range.minX; x <= range.maxX; ++x) {
+            for (uint32_t index : buckets[BucketIndex(x, y)]) {
+                if (index < firstIndex) {
+                    continue;
+                }
+
+                // Report an entry only from the first cell it shares with the query, so entries spanning
+                // several cells (or sharing a bucket with another cell) are reported once
+                const CellRange& other = ranges[index];
+                if (x == std::max(range.minX, other.minX) && y == std::max(range.minY, other.minY) &&
+                    x <= other.maxX && y <= other.maxY) {
+                    results.push_back(index);
+                }
+            }
+        }
+    }
+
+    // Oversized entries are candidates for every query
+    for (uint32_t index : oversized) {
+        if (index >= firstIndex) {
+            results.push_back(index);
+        }
+    }
+
+    // Candidates are visited in index order so pair processing matches the all-pairs loop
+    std::sort(results.begin(), results.end());
+}
+
+SpatialHashGrid::CellRange SpatialHashGrid::ComputeRange(const AABB& bounds) const {
+    CellRange range;
+    range.minX = ToCell(bounds.minX);
+    range.minY = ToCell(bounds.minY);
+    range.maxX = std::max(range.minX, ToCell(bounds.maxX));
+    range.maxY = std::max(range.minY, ToCell(bounds.maxY));
+    return range;
+}
+
+int SpatialHashGrid::ToCell(float coordinate) const {
+    // Clamp so extreme or non-finite coordinates cannot overflow the cell index
+    constexpr float limit = static_cast<float>(1 << 29);
+    float cell = std::floor(coordinate / cellSize);
+    if (!(cell >= -limit)) {
+        return -(1 << 29);
+    }
+    if (cell > limit) {
+        return 1 << 29;
+    }
+    return static_cast<int>(cell);
+}
+
+size_t SpatialHashGrid::BucketIndex(int cellX, int cellY) const {
+    uint32_t hash = (static_cast<uint32_t>(cellX) * 73856093u) ^ (static_cast<uint32_t>(cellY) * 19349663u);
+    return static_cast<size_t>(hash) & bucketMask;
+}
+
+int64_t SpatialHashGrid::CellCount(const CellRange& range) {
+    return (static_cast<int64_t>(range.maxX) - range.minX + 1) * (static_cast<int64_t>(range.maxY) - range.minY + 1);
+}
+
+}
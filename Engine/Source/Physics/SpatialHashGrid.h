@@ -0,0 +1,79 @@
+#ifndef SPATIALHASHGRID_H
+#define SPATIALHASHGRID_H
+
+#include "AABB.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace RiverCore {
+
+// Uniform spatial hash grid used as the collision broadphase
+// Entities are binned into every cell their bounds cover; cells are hashed into a bucket table sized for the
+// current entity count, so only nearby entities become candidate pairs. Entities covering too many cells are
+// kept in a separate list that is returned by every query instead of being binned.
+class SpatialHashGrid {
+public:
+    SpatialHashGrid() = default;
+    ~SpatialHashGrid() = default;
+
+    // Function to set the cell size (world units)
+    void SetCellSize(float size);
+    // Function to get the cell size (world units)
+    float GetCellSize() const { return cellSize; }
+
+    // Removes every entry and sizes the bucket table for the expected number of entries
+    void Clear(size_t expectedCount);
+    // Inserts an entity index with its world space bounds
+    void Insert(uint32_t index, const AABB& bounds);
+    // Removes an entity index
+    void Remove(uint32_t index);
+    // Moves an entity index to new bounds (no-op if it still covers the same cells)
+    void Update(uint32_t index, const AABB& bounds);
+
+    // Collects the indices greater than minIndex whose cells overlap the bounds, sorted ascending
+    // Queries do not modify the grid, so several threads may query it at once
+    void Query(const AABB& bounds, uint32_t minIndex, std::vector<uint32_t>& results) const;
+    // Collects every index whose cells overlap the bounds, sorted ascending
+    void Query(const AABB& bounds, std::vector<uint32_t>& results) const;
+
+private:
+    // Range of cells covered by an entry
+    struct CellRange {
+        int minX = 0;
+        int minY = 0;
+        int maxX = 0;
+        int maxY = 0;
+        bool oversized = false;
+        bool inserted = false;
+    };
+
+    // Largest number of cells an entry is binned into before it is treated as oversized
+    static constexpr int64_t MAX_CELLS_PER_ENTRY = 64;
+
+    // Cell size in world units
+    float cellSize = 128.0f;
+    // Hashed cell buckets holding entity indices
+    std::vector<std::vector<uint32_t>> buckets;
+    // Bucket index mask (bucket count is a power of two)
+    size_t bucketMask = 0;
+    // Cell range of each inserted index
+    std::vector<CellRange> ranges;
+    // Indices covering too many cells to bin
+    std::vector<uint32_t> oversized;
+
+    // Collects the indices from firstIndex on whose cells overlap the bounds, sorted ascending
+    void QueryFrom(const AABB& bounds, uint32_t firstIndex, std::vector<uint32_t>& results) const;
+    // Computes the range of cells covered by world space bounds
+    CellRange ComputeRange(const AABB& bounds) const;
+    // Converts a world space coordinate to a cell coordinate
+    int ToCell(float coordinate) const;
+    // Hashes a cell coordinate to a bucket index
+    size_t BucketIndex(int cellX, int cellY) const;
+    // Returns the number of cells in a range
+    static int64_t CellCount(const CellRange& range);
+};
+
+}
+
+#endif
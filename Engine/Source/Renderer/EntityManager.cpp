@@ -1,6 +1,7 @@
 #include "EntityManager.h"
 #include <SDL3/SDL_log.h>
-#include <SDL3_image/SDL_image.h>
+#include <algorithm>
+#include <atomic>
 
 namespace RiverCore {
 
@@ -9,13 +10,7 @@ EntityManager::EntityManager() {
 }
 
 EntityManager::~EntityManager() {
-    std::lock_guard<std::mutex> lock(entityMutex);
-    // Clean up any loaded textures
-    for (auto& entity : entities) {
-        if (entity.spriteSheet != nullptr) {
-            SDL_DestroyTexture(entity.spriteSheet);
-        }
-    }
+    // Shared textures are destroyed by the texture cache
 }
 
 uint32_t EntityManager::AddEntity(const char* spritePath, float Xpos, float Ypos, float rotation,
@@ -27,18 +22,17 @@ uint32_t EntityManager::AddEntity(const char* spritePath, float Xpos, float Ypos
         return 0;
     }
 
-    std::lock_guard<std::mutex> lock(entityMutex);
-
-    // Load texture and get dimensions
-    TextureInfo textureInfo = LoadTexture(spritePath);
+    // Acquire the shared texture before locking, so decoding a new sprite does not stall other threads
+    TextureInfo textureInfo = textureCache.Acquire(spritePath);
     // Check if loading failed (null texture AND zero dimensions)
     // In headless mode, texture will be null but dimensions will be valid
     if (!textureInfo.texture && textureInfo.width == 0.0f && textureInfo.height == 0.0f) {
         return 0; // Failed to load texture/dimensions
     }
 
+    std::lock_guard<std::mutex> lock(entityMutex);
+
     Entity newEntity;
-    newEntity.ID = nextEntityID++;
     newEntity.spritePath = spritePath;  // Store for replication
     newEntity.spriteSheet = textureInfo.texture;
     newEntity.spriteWidth = textureInfo.width;
@@ -48,11 +42,8 @@ uint32_t EntityManager::AddEntity(const char* spritePath, float Xpos, float Ypos
     newEntity.scale = Vec2(Xscale, Yscale);
     newEntity.physApplied = physEnabled;
 
-    // Add to the entity vector and update the index map
-    entities.push_back(newEntity);
-    idToIndex[newEntity.ID] = entities.size() - 1;
-
-    return newEntity.ID;
+    // Add to the column storage and assign a handle
+    return InsertEntity(newEntity);
 }
 
 uint32_t EntityManager::AddAnimatedEntity(const char* spritePath, int totalFrames, float fps,
@@ -73,18 +64,17 @@ uint32_t EntityManager::AddAnimatedEntity(const char* spritePath, int totalFrame
         return 0;
     }
 
-    std::lock_guard<std::mutex> lock(entityMutex);
-
-    // Load texture and get dimensions
-    TextureInfo textureInfo = LoadTexture(spritePath);
+    // Acquire the shared texture before locking, so decoding a new sprite does not stall other threads
+    TextureInfo textureInfo = textureCache.Acquire(spritePath);
     // Check if loading failed (null texture AND zero dimensions)
     // In headless mode, texture will be null but dimensions will be valid
     if (!textureInfo.texture && textureInfo.width == 0.0f && textureInfo.height == 0.0f) {
         return 0; // Failed to load texture/dimensions
     }
 
+    std::lock_guard<std::mutex> lock(entityMutex);
+
     Entity newEntity;
-    newEntity.ID = nextEntityID++;
     newEntity.spritePath = spritePath;  // Store for replication
     newEntity.spriteSheet = textureInfo.texture;
     newEntity.spriteWidth = textureInfo.width;
@@ -100,11 +90,8 @@ uint32_t EntityManager::AddAnimatedEntity(const char* spritePath, int totalFrame
     newEntity.currentFrame = 0;
     newEntity.elapsedTime = 0.0f;
 
-    // Add to the entity vector and update the index map
-    entities.push_back(newEntity);
-    idToIndex[newEntity.ID] = entities.size() - 1;
-
-    return newEntity.ID;
+    // Add to the column storage and assign a handle
+    return InsertEntity(newEntity);
 }
 
 uint32_t EntityManager::AddSpritelessEntity(float width, float height, uint8_t r, uint8_t g, uint8_t b, uint8_t a,
@@ -113,7 +100,6 @@ uint32_t EntityManager::AddSpritelessEntity(float width, float height, uint8_t r
     std::lock_guard<std::mutex> lock(entityMutex);
 
     Entity newEntity;
-    newEntity.ID = nextEntityID++;
     newEntity.isSpriteless = true;
     newEntity.spritelessWidth = width;
     newEntity.spritelessHeight = height;
@@ -136,98 +122,148 @@ uint32_t EntityManager::AddSpritelessEntity(float width, float height, uint8_t r
     newEntity.spriteWidth = width;
     newEntity.spriteHeight = height;
 
-    // Add to the entity vector and update the index map
-    entities.push_back(newEntity);
-    idToIndex[newEntity.ID] = entities.size() - 1;
-
-    return newEntity.ID;
+    // Add to the column storage and assign a handle
+    return InsertEntity(newEntity);
 }
 
 void EntityManager::RemoveEntity(uint32_t entityID) {
     std::lock_guard<std::mutex> lock(entityMutex);
 
-    auto it = idToIndex.find(entityID);
-    if (it == idToIndex.end()) {
-        return; // Entity not found
+    size_t index;
+    if (!slotMap.Find(entityID, index)) {
+        return; // Entity not found (or stale handle)
     }
 
-    size_t index = it->second;
-
-    // Clean up texture if it exists
-    if (entities[index].spriteSheet != nullptr) {
-        SDL_DestroyTexture(entities[index].spriteSheet);
-    }
+    // Release this entity's reference to its shared texture
+    ReleaseTexture(index);
+    textureCache.CollectUnused(GetOldestFrameInUse());
 
-    // Remove from entity vector using swap-and-pop for efficiency
-    if (index < entities.size() - 1) {
-        std::swap(entities[index], entities.back());
+    // Remove from every column using swap-and-pop, then repoint the handle of the entity moved into the gap
+    storage.SwapAndPop(index);
+    slotMap.Free(entityID);
+    if (index < storage.Size()) {
+        slotMap.Relocate(storage.ids[index], index);
     }
-    entities.pop_back();
-
-    // Remove from index map and update
-    idToIndex.erase(it);
-    UpdateIndexMap();
 }
 
 void EntityManager::ClearEntities() {
     std::lock_guard<std::mutex> lock(entityMutex);
 
-    // Clean up all textures
-    for (auto& entity : entities) {
-        if (entity.spriteSheet != nullptr) {
-            SDL_DestroyTexture(entity.spriteSheet);
-        }
+    // Release every entity's reference to its shared texture
+    for (size_t i = 0; i < storage.Size(); ++i) {
+        ReleaseTexture(i);
     }
+    textureCache.CollectUnused(GetOldestFrameInUse());
 
-    entities.clear();
-    idToIndex.clear();
-    nextEntityID = 1;
+    storage.Clear();
+    slotMap.Clear();
 }
 
-std::vector<Entity> EntityManager::GetEntitiesCopy() const {
+bool EntityManager::PreloadTexture(const std::string& spritePath) {
+    // Loaded without locking, like a new entity's sprite
+    TextureInfo textureInfo = textureCache.Acquire(spritePath);
+    return textureInfo.texture || textureInfo.width != 0.0f || textureInfo.height != 0.0f;
+}
+
+void EntityManager::ReleasePreloadedTexture(const std::string& spritePath) {
     std::lock_guard<std::mutex> lock(entityMutex);
-    return entities; // Copy the vector
+
+    // Entities spawned with the sprite since it was preloaded may still be in the newest published frame
+    textureCache.Release(spritePath, publishedFrameCount);
+    textureCache.CollectUnused(GetOldestFrameInUse());
 }
 
-Entity* EntityManager::GetEntityByID(uint32_t ID) {
+std::vector<Entity> EntityManager::GetEntitiesCopy() const {
     std::lock_guard<std::mutex> lock(entityMutex);
 
-    auto it = idToIndex.find(ID);
-    if (it == idToIndex.end()) {
-        return nullptr;
+    // Gather every entity out of the columns
+    std::vector<Entity> entities;
+    entities.reserve(storage.Size());
+    for (size_t i = 0; i < storage.Size(); ++i) {
+        entities.push_back(storage.Load(i));
     }
-
-    return &entities[it->second];
+    return entities;
 }
 
 size_t EntityManager::GetEntityCount() const {
     std::lock_guard<std::mutex> lock(entityMutex);
-    return entities.size();
+    return storage.Size();
 }
 
 bool EntityManager::EntityExists(uint32_t ID) const {
     std::lock_guard<std::mutex> lock(entityMutex);
-    return idToIndex.find(ID) != idToIndex.end();
+    return slotMap.Contains(ID);
 }
 
 bool EntityManager::GetEntityProperty(uint32_t ID, std::function<void(const Entity&)> accessor) const {
     std::lock_guard<std::mutex> lock(entityMutex);
 
-    auto it = idToIndex.find(ID);
-    if (it == idToIndex.end()) {
+    size_t index;
+    if (!slotMap.Find(ID, index)) {
+        return false; // Entity not found
+    }
+
+    accessor(storage.Load(index));
+    return true;
+}
+
+bool EntityManager::ModifyEntity(uint32_t ID, std::function<void(Entity&)> mutator) {
+    std::lock_guard<std::mutex> lock(entityMutex);
+
+    size_t index;
+    if (!slotMap.Find(ID, index)) {
         return false; // Entity not found
     }
 
-    accessor(entities[it->second]);
+    Entity entity = storage.Load(index);
+    mutator(entity);
+    entity.ID = ID; // The ID is owned by the entity manager
+    storage.Store(index, entity);
     return true;
 }
 
+void EntityManager::ReadStorage(std::function<void(const EntityStorage&)> reader) const {
+    std::lock_guard<std::mutex> lock(entityMutex);
+    reader(storage);
+}
+
+std::shared_ptr<const FrameState> EntityManager::PublishFrameState() {
+    std::lock_guard<std::mutex> lock(entityMutex);
+
+    // Recycle a buffer no reader holds anymore (the pool is its only owner), or grow the pool
+    std::shared_ptr<FrameState> frame;
+    for (const std::shared_ptr<FrameState>& buffer : framePool) {
+        if (buffer.use_count() == 1) {
+            // use_count is a relaxed load: order the overwrite after the last reader's final reads
+            std::atomic_thread_fence(std::memory_order_acquire);
+            frame = buffer;
+            break;
+        }
+    }
+    if (!frame) {
+        frame = std::make_shared<FrameState>();
+        framePool.push_back(frame);
+    }
+
+    frame->frameNumber = ++publishedFrameCount;
+    frame->CopyFrom(storage);
+
+    // Swap the new frame in for readers
+    std::shared_ptr<const FrameState> published = frame;
+    std::atomic_store(&publishedFrame, published);
+
+    // Textures released before the oldest frame still being read can now be destroyed
+    textureCache.CollectUnused(GetOldestFrameInUse());
+
+    return published;
+}
+
 void EntityManager::UpdateEntityPosition(uint32_t entityID, float newX, float newY) {
     std::lock_guard<std::mutex> lock(entityMutex);
 
-    auto it = idToIndex.find(entityID);
-    if (it != idToIndex.end()) {
-        entities[it->second].position = Vec2(newX, newY);
+    size_t index;
+    if (slotMap.Find(entityID, index)) {
+        storage.transform.position[index] = Vec2(newX, newY);
     } else {
         SDL_LogError(SDL_LOG_CATEGORY_ERROR, "UpdateEntityPosition: Entity ID %u not found", entityID);
     }
@@ -236,10 +272,10 @@ void EntityManager::UpdateEntityPosition(uint32_t entityID, float newX, float ne
 void EntityManager::FlipSprite(uint32_t entityID, bool flipX, bool flipY) {
     std::lock_guard<std::mutex> lock(entityMutex);
 
-    auto it = idToIndex.find(entityID);
-    if (it != idToIndex.end()) {
-        entities[it->second].flipX = flipX;
-        entities[it->second].flipY = flipY;
+    size_t index;
+    if (slotMap.Find(entityID, index)) {
+        storage.transform.flipX[index] = flipX;
+        storage.transform.flipY[index] = flipY;
     } else {
         SDL_LogError(SDL_LOG_CATEGORY_ERROR, "FlipSprite: Entity ID %u not found", entityID);
     }
@@ -248,20 +284,40 @@ void EntityManager::FlipSprite(uint32_t entityID, bool flipX, bool flipY) {
 void EntityManager::SetPosition(uint32_t entityID, const Vec2& position) {
     std::lock_guard<std::mutex> lock(entityMutex);
 
-    auto it = idToIndex.find(entityID);
-    if (it != idToIndex.end()) {
-        entities[it->second].position = position;
+    size_t index;
+    if (slotMap.Find(entityID, index)) {
+        storage.transform.position[index] = position;
     } else {
         SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SetPosition: Entity ID %u not found", entityID);
     }
 }
 
+Vec2 EntityManager::GetPosition(uint32_t entityID) const {
+    std::lock_guard<std::mutex> lock(entityMutex);
+
+    size_t index;
+    if (slotMap.Find(entityID, index)) {
+        return storage.transform.position[index];
+    }
+    return Vec2::zero();
+}
+
+Vec2 EntityManager::GetVelocity(uint32_t entityID) const {
+    std::lock_guard<std::mutex> lock(entityMutex);
+
+    size_t index;
+    if (slotMap.Find(entityID, index)) {
+        return storage.body.velocity[index];
+    }
+    return Vec2::zero();
+}
+
 bool EntityManager::GetFlipX(uint32_t entityID) const {
     std::lock_guard<std::mutex> lock(entityMutex);
 
-    auto it = idToIndex.find(entityID);
-    if (it != idToIndex.end()) {
-        return entities[it->second].flipX;
+    size_t index;
+    if (slotMap.Find(entityID, index)) {
+        return storage.transform.flipX[index] != 0;
     } else {
         SDL_LogError(SDL_LOG_CATEGORY_ERROR, "GetFlipX: Entity ID %u not found", entityID);
         return false;
@@ -271,9 +327,9 @@ bool EntityManager::GetFlipX(uint32_t entityID) const {
 bool EntityManager::GetFlipY(uint32_t entityID) const {
     std::lock_guard<std::mutex> lock(entityMutex);
 
-    auto it = idToIndex.find(entityID);
-    if (it != idToIndex.end()) {
-        return entities[it->second].flipY;
+    size_t index;
+    if (slotMap.Find(entityID, index)) {
+        return storage.transform.flipY[index] != 0;
     } else {
         SDL_LogError(SDL_LOG_CATEGORY_ERROR, "GetFlipY: Entity ID %u not found", entityID);
         return false;
@@ -283,10 +339,10 @@ bool EntityManager::GetFlipY(uint32_t entityID) const {
 bool EntityManager::GetFlipState(uint32_t entityID, bool& flipX, bool& flipY) const {
     std::lock_guard<std::mutex> lock(entityMutex);
 
-    auto it = idToIndex.find(entityID);
-    if (it != idToIndex.end()) {
-        flipX = entities[it->second].flipX;
-        flipY = entities[it->second].flipY;
+    size_t index;
+    if (slotMap.Find(entityID, index)) {
+        flipX = storage.transform.flipX[index] != 0;
+        flipY = storage.transform.flipY[index] != 0;
         return true;
     } else {
         SDL_LogError(SDL_LOG_CATEGORY_ERROR, "GetFlipState: Entity ID %u not found", entityID);
@@ -299,9 +355,9 @@ bool EntityManager::GetFlipState(uint32_t entityID, bool& flipX, bool& flipY) co
 void EntityManager::ToggleFlipX(uint32_t entityID) {
     std::lock_guard<std::mutex> lock(entityMutex);
 
-    auto it = idToIndex.find(entityID);
-    if (it != idToIndex.end()) {
-        entities[it->second].flipX = !entities[it->second].flipX;
+    size_t index;
+    if (slotMap.Find(entityID, index)) {
+        storage.transform.flipX[index] = !storage.transform.flipX[index];
     } else {
         SDL_LogError(SDL_LOG_CATEGORY_ERROR, "ToggleFlipX: Entity ID %u not found", entityID);
     }
@@ -310,9 +366,9 @@ void EntityManager::ToggleFlipX(uint32_t entityID) {
 void EntityManager::ToggleFlipY(uint32_t entityID) {
     std::lock_guard<std::mutex> lock(entityMutex);
 
-    auto it = idToIndex.find(entityID);
-    if (it != idToIndex.end()) {
-        entities[it->second].flipY = !entities[it->second].flipY;
+    size_t index;
+    if (slotMap.Find(entityID, index)) {
+        storage.transform.flipY[index] = !storage.transform.flipY[index];
     } else {
         SDL_LogError(SDL_LOG_CATEGORY_ERROR, "ToggleFlipY: Entity ID %u not found", entityID);
     }
@@ -321,121 +377,99 @@ void EntityManager::ToggleFlipY(uint32_t entityID) {
 void EntityManager::SetColliderType(uint32_t entityID, ColliderType type) {
     std::lock_guard<std::mutex> lock(entityMutex);
 
-    auto it = idToIndex.find(entityID);
-    if (it != idToIndex.end()) {
-        entities[it->second].collider.type = type;
+    size_t index;
+    if (slotMap.Find(entityID, index)) {
+        storage.collider.type[index] = type;
     } else {
         SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SetColliderType: Entity ID %u not found", entityID);
     }
 }
 
-void EntityManager::UpdatePhysics(std::function<void(std::vector<Entity>&)> physicsUpdate) {
-    // Copy entities to a new vector under a short lock
-    std::vector<Entity> entitiesCopy;
+void EntityManager::UpdatePhysics(std::function<void(EntityStorage&)> physicsUpdate) {
+    // Snapshot only the physics columns under a short lock
     {
         std::lock_guard<std::mutex> lock(entityMutex);
-        entitiesCopy = entities;
+        physicsStorage.CopyPhysicsColumns(storage);
     }
+    // Forces accumulated so far are used up by this step
+    physicsAccelerations = physicsStorage.body.acceleration;
 
-    // Work on the copy
-    physicsUpdate(entitiesCopy);
+    // Work on the snapshot
+    physicsUpdate(physicsStorage);
 
     // Apply changes back under a short lock
-    {
-        std::lock_guard<std::mutex> lock(entityMutex);
-        // Copy physics results back (positions, velocities, collisions)
-        for (size_t i = 0; i < entities.size() && i < entitiesCopy.size(); ++i) {
-            if (entities[i].physApplied) {
-                entities[i].position = entitiesCopy[i].position;
-                entities[i].velocity = entitiesCopy[i].velocity;
-            }
-            // Update colliders
-            entities[i].collider = entitiesCopy[i].collider;
+    std::lock_guard<std::mutex> lock(entityMutex);
+    for (size_t i = 0; i < physicsStorage.Size(); ++i) {
+        // Match by ID, since entities may have been added or removed (and moved by swap-and-pop) meanwhile
+        size_t index;
+        if (!slotMap.Find(physicsStorage.ids[i], index)) {
+            continue;
         }
+
+        // Copy physics results back (positions, velocities, consumed forces)
+        if (physicsStorage.body.physApplied[i]) {
+            storage.transform.position[index] = physicsStorage.transform.position[i];
+            storage.body.velocity[index] = physicsStorage.body.velocity[i];
+            // Forces applied while the step ran are kept for the next one
+            storage.body.acceleration[index] -= physicsAccelerations[i];
+        }
+
+        // Update collision records (the snapshot's old list is cleared by the next step)
+        std::swap(storage.contacts[index], physicsStorage.contacts[i]);
     }
 }
 
 void EntityManager::UpdateAnimations(float deltaTime) {
     std::lock_guard<std::mutex> lock(entityMutex);
 
-    // Handle animation updates for entities that need it
-    for (auto& entity : entities) {
-        if (entity.totalFrames > 1) {
-            entity.elapsedTime += deltaTime;
-            float frameTime = 1.0f / entity.fps;
+    // Handle animation updates for entities that need it (only the animation columns are touched)
+    AnimationColumns& animation = storage.animation;
+    for (size_t i = 0; i < storage.Size(); ++i) {
+        if (animation.totalFrames[i] > 1) {
+            animation.elapsedTime[i] += deltaTime;
+            float frameTime = 1.0f / animation.fps[i];
 
-            while (entity.elapsedTime >= frameTime) {
-                entity.currentFrame = (entity.currentFrame + 1) % entity.totalFrames;
-                entity.elapsedTime -= frameTime;
+            while (animation.elapsedTime[i] >= frameTime) {
+                animation.currentFrame[i] = (animation.currentFrame[i] + 1) % animation.totalFrames[i];
+                animation.elapsedTime[i] -= frameTime;
             }
         }
     }
 }
 
-void EntityManager::UpdateIndexMap() {
-    idToIndex.clear();
-    for (size_t i = 0; i < entities.size(); ++i) {
-        idToIndex[entities[i].ID] = i;
+void EntityManager::ReleaseTexture(size_t index) {
+    if (storage.render.isSpriteless[index]) {
+        return;
     }
-}
-
-TextureInfo EntityManager::LoadTexture(const char* spritePath) {
-    TextureInfo result = {nullptr, 0.0f, 0.0f};
 
-    // In headless mode, skip texture loading but still get dimensions
-    if (headlessMode) {
-        // Load image to get dimensions (needed for physics/collisions)
-        SDL_Surface *spriteSheet = IMG_Load(spritePath);
+    // The newest published frame may still contain this entity
+    textureCache.Release(storage.render.spritePath[index], publishedFrameCount);
+}
 
-        if (!spriteSheet) {
-            SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Failed to load image %s: %s", spritePath, SDL_GetError());
-            return result;
+uint64_t EntityManager::GetOldestFrameInUse() const {
+    // A pooled buffer is in use while the published slot or a reader holds another reference to it
+    uint64_t oldest = publishedFrameCount + 1;
+    for (const std::shared_ptr<FrameState>& buffer : framePool) {
+        if (buffer.use_count() > 1) {
+            oldest = std::min(oldest, buffer->frameNumber);
         }
-
-        // Get dimensions from the surface
-        result.width = static_cast<float>(spriteSheet->w);
-        result.height = static_cast<float>(spriteSheet->h);
-        result.texture = nullptr;  // No texture in headless mode
-
-        // Free the image surface
-        SDL_DestroySurface(spriteSheet);
-
-        return result;
-    }
-
-    // Normal mode: require renderer
-    if (!rendererRef) {
-        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Renderer not set in EntityManager");
-        return result;
     }
+    return oldest;
+}
 
-    // Load an image for the entity sprite
-    SDL_Surface *spriteSheet = IMG_Load(spritePath);
-
-    // Check if the image was loaded successfully
-    if (!spriteSheet) {
-        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Failed to load image %s: %s", spritePath, SDL_GetError());
-        return result;
-    }
-
-    // Get dimensions from the surface
-    result.width = static_cast<float>(spriteSheet->w);
-    result.height = static_cast<float>(spriteSheet->h);
-
-    // Create texture from the surface
-    result.texture = SDL_CreateTextureFromSurface(rendererRef, spriteSheet);
-
-    // Free the image surface after creating the texture
-    SDL_DestroySurface(spriteSheet);
-
-    if (!result.texture) {
-        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Failed to create texture: %s", SDL_GetError());
-        result.width = 0.0f;
-        result.height = 0.0f;
-        return result;
+uint32_t EntityManager::InsertEntity(Entity& entity) {
+    entity.ID = slotMap.Allocate(storage.Size());
+    if (entity.ID == 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "InsertEntity: Entity limit reached");
+        if (!entity.isSpriteless) {
+            textureCache.Release(entity.spritePath, publishedFrameCount);
+            textureCache.CollectUnused(GetOldestFrameInUse());
+        }
+        return 0;
     }
 
-    return result;
+    storage.Push(entity);
+    return entity.ID;
 }
 
 }
\ No newline at end of file
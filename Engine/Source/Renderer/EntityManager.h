@@ -2,31 +2,29 @@
 #define ENTITYMANAGER_H
 
 #include "Entity.h"
+#include "EntityStorage.h"
+#include "EntitySlotMap.h"
+#include "FrameState.h"
+#include "TextureCache.h"
 #include "Math/Math.h"
 #include <vector>
 #include <unordered_map>
 #include <mutex>
 #include <functional>
+#include <memory>
 #include <SDL3/SDL.h>
 
 namespace RiverCore {
 
-// Struct to hold texture and its dimensions
-struct TextureInfo {
-    SDL_Texture* texture;
-    float width;
-    float height;
-};
-
 class EntityManager {
 public:
     EntityManager();
     ~EntityManager();
 
     // Set renderer for texture loading
-    void SetRenderer(SDL_Renderer* renderer) { rendererRef = renderer; }
+    void SetRenderer(SDL_Renderer* renderer) { textureCache.SetRenderer(renderer); }
     // Set headless mode (for server-side entity management without graphics)
-    void SetHeadlessMode(bool headless) { headlessMode = headless; }
+    void SetHeadlessMode(bool headless) { textureCache.SetHeadlessMode(headless); }
 
     // Thread-safe function to add an entity
     uint32_t AddEntity(const char* spritePath, float Xpos = 0.0f, float Ypos = 0.0f, float rotation = 0.0f,
@@ -42,10 +40,14 @@ public:
     // Thread-safe function to clear all entities
     void ClearEntities();
 
+    // Thread-safe function to load a sprite ahead of the entities using it, holding a reference until released
+    // Returns false if the sprite could not be loaded (no reference is held in that case)
+    bool PreloadTexture(const std::string& spritePath);
+    // Thread-safe function to release a reference taken by PreloadTexture
+    void ReleasePreloadedTexture(const std::string& spritePath);
+
     // Thread-safe function to get a copy of all entities
     std::vector<Entity> GetEntitiesCopy() const;
-    // Thread-safe function to get a pointer to an entity using an ID
-    Entity* GetEntityByID(uint32_t ID);
     // Thread-safe function to get the current entity count
     size_t GetEntityCount() const;
 
@@ -53,6 +55,15 @@ public:
     bool EntityExists(uint32_t ID) const;
     // Thread-safe function to get a property of an entity
     bool GetEntityProperty(uint32_t ID, std::function<void(const Entity&)> accessor) const;
+    // Thread-safe function to modify an entity (gathered from and scattered back into the columns)
+    bool ModifyEntity(uint32_t ID, std::function<void(Entity&)> mutator);
+    // Thread-safe function to read the column storage without copying it
+    void ReadStorage(std::function<void(const EntityStorage&)> reader) const;
+
+    // Thread-safe function to publish a read-only snapshot of the entity columns (called once per simulation tick)
+    std::shared_ptr<const FrameState> PublishFrameState();
+    // Lock-free function to get the most recently published frame state (null until the first publish)
+    std::shared_ptr<const FrameState> GetFrameState() const { return std::atomic_load(&publishedFrame); }
 
     // Thread-safe function to update an entity's position
     void UpdateEntityPosition(uint32_t entityID, float newX, float newY);
@@ -60,6 +71,10 @@ public:
     void FlipSprite(uint32_t entityID, bool flipX, bool flipY);
     // Thread-safe function to set an entity's position
     void SetPosition(uint32_t entityID, const Vec2& position);
+    // Thread-safe function to get an entity's position
+    Vec2 GetPosition(uint32_t entityID) const;
+    // Thread-safe function to get an entity's velocity
+    Vec2 GetVelocity(uint32_t entityID) const;
 
     // Thread-safe function to get the X-axis flip state of an entity's sprite
     bool GetFlipX(uint32_t entityID) const;
@@ -77,34 +92,46 @@ public:
     void SetColliderType(uint32_t entityID, ColliderType type);
 
     // Thread-safe function to update the physics of all entities
-    void UpdatePhysics(std::function<void(std::vector<Entity>&)> physicsUpdate);
+    void UpdatePhysics(std::function<void(EntityStorage&)> physicsUpdate);
 
     // Thread-safe function to update the animations of all entities
     void UpdateAnimations(float deltaTime);
 
     // Function to get the mutex for thread-safe operations
     std::mutex& GetMutex() { return entityMutex; }
-    // Function to get the entity vector for thread-safe operations
-    std::vector<Entity>& GetEntitiesUnsafe() { return entities; }
+    // Function to get the column storage for thread-safe operations
+    EntityStorage& GetStorageUnsafe() { return storage; }
+    // Function to get the shared sprite texture cache
+    TextureCache& GetTextureCache() { return textureCache; }
 
 private:
     // Mutex for thread-safe operations
     mutable std::mutex entityMutex;
-    // Vector of entities
-    std::vector<Entity> entities;
-    // Map of entity IDs to indices in the vector
-    std::unordered_map<uint32_t, size_t> idToIndex;
-    // Next available entity ID
-    uint32_t nextEntityID = 1;
-    // Reference to the SDL renderer
-    SDL_Renderer* rendererRef = nullptr;
-    // Headless mode flag (no texture loading for server)
-    bool headlessMode = false;
-
-    // Function to load a texture from a file path
-    TextureInfo LoadTexture(const char* spritePath);
-    // Function to update the index map for entity IDs
-    void UpdateIndexMap();
+    // Column-oriented entity storage
+    EntityStorage storage;
+    // Generational entity handles mapped to dense indices in the storage columns
+    EntitySlotMap slotMap;
+    // Shared sprite textures (one texture per path, released with the last entity using it)
+    TextureCache textureCache;
+
+    // Physics column snapshot the physics step works on (only used by the physics thread, kept to reuse its capacity)
+    EntityStorage physicsStorage;
+    // Accelerations handed to the last physics step
+    std::vector<Vec2> physicsAccelerations;
+
+    // Most recently published frame state
+    std::shared_ptr<const FrameState> publishedFrame;
+    // Frame buffers recycled between publishes (a buffer is reused once no reader holds it)
+    std::vector<std::shared_ptr<FrameState>> framePool;
+    // Number of frames published so far
+    uint64_t publishedFrameCount = 0;
+
+    // Function to add an entity to the storage and assign it a handle (returns 0 if no handle is available)
+    uint32_t InsertEntity(Entity& entity);
+    // Function to release an entity's reference to its shared sprite texture
+    void ReleaseTexture(size_t index);
+    // Function to get the oldest frame number still held by a reader (or the next frame if none is held)
+    uint64_t GetOldestFrameInUse() const;
 };
 
 }
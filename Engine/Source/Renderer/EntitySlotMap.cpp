@@ -0,0 +1,73 @@
+#include "EntitySlotMap.h"
+
+namespace RiverCore {
+
+uint32_t EntitySlotMap::Allocate(size_t denseIndex) {
+    uint32_t slot;
+    if (!freeSlots.empty()) {
+        // Reuse a released slot (its generation was already advanced on release)
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        if (slots.size() > SLOT_MASK) {
+            return 0; // Out of slots
+        }
+        slot = static_cast<uint32_t>(slots.size());
+        slots.emplace_back();
+    }
+
+    slots[slot].denseIndex = denseIndex;
+    return MakeID(slot, slots[slot].generation);
+}
+
+void EntitySlotMap::Free(uint32_t ID) {
+    if (!Contains(ID)) {
+        return;
+    }
+
+    Slot& slot = slots[GetSlot(ID)];
+    slot.denseIndex = INVALID_INDEX;
+
+    // Advance the generation so existing copies of this handle become stale (skipping 0 keeps IDs nonzero)
+    slot.generation = (slot.generation + 1) & GENERATION_MASK;
+    if (slot.generation == 0) {
+        slot.generation = 1;
+    }
+
+    freeSlots.push_back(GetSlot(ID));
+}
+
+void EntitySlotMap::Relocate(uint32_t ID, size_t denseIndex) {
+    if (Contains(ID)) {
+        slots[GetSlot(ID)].denseIndex = denseIndex;
+    }
+}
+
+bool EntitySlotMap::Find(uint32_t ID, size_t& denseIndex) const {
+    if (!Contains(ID)) {
+        return false;
+    }
+
+    denseIndex = slots[GetSlot(ID)].denseIndex;
+    return true;
+}
+
+bool EntitySlotMap::Contains(uint32_t ID) const {
+    uint32_t slot = GetSlot(ID);
+    if (slot >= slots.size()) {
+        return false;
+    }
+
+    const Slot& record = slots[slot];
+    return record.denseIndex != INVALID_INDEX && record.generation == GetGeneration(ID);
+}
+
+void EntitySlotMap::Clear() {
+    for (uint32_t slot = 0; slot < slots.size(); ++slot) {
+        if (slots[slot].denseIndex != INVALID_INDEX) {
+            Free(MakeID(slot, slots[slot].generation));
+        }
+    }
+}
+
+}
@@ -0,0 +1,59 @@
+#ifndef ENTITYSLOTMAP_H
+#define ENTITYSLOTMAP_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace RiverCore {
+
+// Slot map translating generational entity handles into dense storage indices
+// An entity ID packs a slot index (low bits) and the slot's generation (high bits), so add, remove and
+// lookup are O(1) and a handle to a removed entity is rejected once its slot is reused
+class EntitySlotMap {
+public:
+    // Number of bits used for the slot index (about one million live entities)
+    static constexpr uint32_t SLOT_BITS = 20;
+    static constexpr uint32_t SLOT_MASK = (1u << SLOT_BITS) - 1;
+    // Generation counter wraps within the remaining bits and never reaches zero, so no ID is ever 0
+    static constexpr uint32_t GENERATION_MASK = (1u << (32 - SLOT_BITS)) - 1;
+    // Dense index stored in slots that are not in use
+    static constexpr size_t INVALID_INDEX = static_cast<size_t>(-1);
+
+    // Allocates a handle for an entity stored at a dense index, returns 0 if every slot is in use
+    uint32_t Allocate(size_t denseIndex);
+    // Releases a handle, invalidating it and every copy of it
+    void Free(uint32_t ID);
+    // Points a live handle at a new dense index (after the entity was moved by a swap-and-pop)
+    void Relocate(uint32_t ID, size_t denseIndex);
+    // Looks up the dense index of a live handle, returns false for unknown or stale handles
+    bool Find(uint32_t ID, size_t& denseIndex) const;
+    // Returns whether a handle refers to a live entity
+    bool Contains(uint32_t ID) const;
+    // Releases every live handle (slots are kept so old handles stay stale)
+    void Clear();
+
+    // Extracts the slot index of a handle
+    static uint32_t GetSlot(uint32_t ID) { return ID & SLOT_MASK; }
+    // Extracts the generation of a handle
+    static uint32_t GetGeneration(uint32_t ID) { return ID >> SLOT_BITS; }
+
+private:
+    // Slot record (generation of the current or next handle, dense index while in use)
+    struct Slot {
+        uint32_t generation = 1;
+        size_t denseIndex = INVALID_INDEX;
+    };
+
+    // All slots ever allocated, indexed by slot index
+    std::vector<Slot> slots;
+    // Slots available for reuse
+    std::vector<uint32_t> freeSlots;
+
+    // Function to build a handle from a slot index and generation
+    static uint32_t MakeID(uint32_t slot, uint32_t generation) { return (generation << SLOT_BITS) | slot; }
+};
+
+}
+
+#endif
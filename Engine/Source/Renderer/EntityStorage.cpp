@@ -0,0 +1,241 @@
+#include "EntityStorage.h"
+
+namespace RiverCore {
+
+namespace {
+
+// Moves the last element of a column into the given index and shrinks the column
+template <typename T>
+void SwapAndPopColumn(std::vector<T>& column, size_t index) {
+    if (index + 1 < column.size()) {
+        column[index] = std::move(column.back());
+    }
+    column.pop_back();
+}
+
+}
+
+size_t EntityStorage::Push(const Entity& entity) {
+    ids.push_back(entity.ID);
+
+    transform.position.push_back(entity.position);
+    transform.rotation.push_back(entity.rotation);
+    transform.scale.push_back(entity.scale);
+    transform.flipX.push_back(entity.flipX);
+    transform.flipY.push_back(entity.flipY);
+
+    body.velocity.push_back(entity.velocity);
+    body.acceleration.push_back(entity.acceleration);
+    body.mass.push_back(entity.mass);
+    body.drag.push_back(entity.drag);
+    body.physApplied.push_back(entity.physApplied);
+
+    collider.type.push_back(entity.collider.type);
+    collider.enabled.push_back(entity.collider.enabled);
+    collider.offset.push_back(entity.collider.offset);
+    collider.size.push_back(entity.collider.size);
+    collider.frameSize.push_back(ComputeFrameSize(entity.spriteWidth, entity.spriteHeight, entity.totalFrames));
+
+    animation.currentFrame.push_back(entity.currentFrame);
+    animation.totalFrames.push_back(entity.totalFrames);
+    animation.fps.push_back(entity.fps);
+    animation.elapsedTime.push_back(entity.elapsedTime);
+
+    SpritelessShape shape;
+    shape.width = entity.spritelessWidth;
+    shape.height = entity.spritelessHeight;
+    shape.r = entity.spritelessR;
+    shape.g = entity.spritelessG;
+    shape.b = entity.spritelessB;
+    shape.a = entity.spritelessA;
+
+    render.spriteSheet.push_back(entity.spriteSheet);
+    render.spriteWidth.push_back(entity.spriteWidth);
+    render.spriteHeight.push_back(entity.spriteHeight);
+    render.isSpriteless.push_back(entity.isSpriteless);
+    render.spriteless.push_back(shape);
+    render.spritePath.push_back(entity.spritePath);
+
+    contacts.push_back(entity.collider.GetCollisions());
+
+    return ids.size() - 1;
+}
+
+Entity EntityStorage::Load(size_t index) const {
+    Entity entity;
+    entity.ID = ids[index];
+
+    entity.position = transform.position[index];
+    entity.rotation = transform.rotation[index];
+    entity.scale = transform.scale[index];
+    entity.flipX = transform.flipX[index] != 0;
+    entity.flipY = transform.flipY[index] != 0;
+
+    entity.velocity = body.velocity[index];
+    entity.acceleration = body.acceleration[index];
+    entity.mass = body.mass[index];
+    entity.drag = body.drag[index];
+    entity.physApplied = body.physApplied[index] != 0;
+
+    entity.collider.type = collider.type[index];
+    entity.collider.enabled = collider.enabled[index] != 0;
+    entity.collider.offset = collider.offset[index];
+    entity.collider.size = collider.size[index];
+    for (const auto& [otherID, side] : contacts[index]) {
+        entity.collider.AddCollision(otherID, side);
+    }
+
+    entity.currentFrame = animation.currentFrame[index];
+    entity.totalFrames = animation.totalFrames[index];
+    entity.fps = animation.fps[index];
+    entity.elapsedTime = animation.elapsedTime[index];
+
+    const SpritelessShape& shape = render.spriteless[index];
+    entity.spriteSheet = render.spriteSheet[index];
+    entity.spriteWidth = render.spriteWidth[index];
+    entity.spriteHeight = render.spriteHeight[index];
+    entity.isSpriteless = render.isSpriteless[index] != 0;
+    entity.spritelessWidth = shape.width;
+    entity.spritelessHeight = shape.height;
+    entity.spritelessR = shape.r;
+    entity.spritelessG = shape.g;
+    entity.spritelessB = shape.b;
+    entity.spritelessA = shape.a;
+    entity.spritePath = render.spritePath[index];
+
+    return entity;
+}
+
+void EntityStorage::Store(size_t index, const Entity& entity) {
+    ids[index] = entity.ID;
+
+    transform.position[index] = entity.position;
+    transform.rotation[index] = entity.rotation;
+    transform.scale[index] = entity.scale;
+    transform.flipX[index] = entity.flipX;
+    transform.flipY[index] = entity.flipY;
+
+    body.velocity[index] = entity.velocity;
+    body.acceleration[index] = entity.acceleration;
+    body.mass[index] = entity.mass;
+    body.drag[index] = entity.drag;
+    body.physApplied[index] = entity.physApplied;
+
+    collider.type[index] = entity.collider.type;
+    collider.enabled[index] = entity.collider.enabled;
+    collider.offset[index] = entity.collider.offset;
+    collider.size[index] = entity.collider.size;
+    collider.frameSize[index] = ComputeFrameSize(entity.spriteWidth, entity.spriteHeight, entity.totalFrames);
+    contacts[index] = entity.collider.GetCollisions();
+
+    animation.currentFrame[index] = entity.currentFrame;
+    animation.totalFrames[index] = entity.totalFrames;
+    animation.fps[index] = entity.fps;
+    animation.elapsedTime[index] = entity.elapsedTime;
+
+    SpritelessShape& shape = render.spriteless[index];
+    shape.width = entity.spritelessWidth;
+    shape.height = entity.spritelessHeight;
+    shape.r = entity.spritelessR;
+    shape.g = entity.spritelessG;
+    shape.b = entity.spritelessB;
+    shape.a = entity.spritelessA;
+    render.spriteSheet[index] = entity.spriteSheet;
+    render.spriteWidth[index] = entity.spriteWidth;
+    render.spriteHeight[index] = entity.spriteHeight;
+    render.isSpriteless[index] = entity.isSpriteless;
+    render.spritePath[index] = entity.spritePath;
+}
+
+void EntityStorage::SwapAndPop(size_t index) {
+    SwapAndPopColumn(ids, index);
+
+    SwapAndPopColumn(transform.position, index);
+    SwapAndPopColumn(transform.rotation, index);
+    SwapAndPopColumn(transform.scale, index);
+    SwapAndPopColumn(transform.flipX, index);
+    SwapAndPopColumn(transform.flipY, index);
+
+    SwapAndPopColumn(body.velocity, index);
+    SwapAndPopColumn(body.acceleration, index);
+    SwapAndPopColumn(body.mass, index);
+    SwapAndPopColumn(body.drag, index);
+    SwapAndPopColumn(body.physApplied, index);
+
+    SwapAndPopColumn(collider.type, index);
+    SwapAndPopColumn(collider.enabled, index);
+    SwapAndPopColumn(collider.offset, index);
+    SwapAndPopColumn(collider.size, index);
+    SwapAndPopColumn(collider.frameSize, index);
+
+    SwapAndPopColumn(animation.currentFrame, index);
+    SwapAndPopColumn(animation.totalFrames, index);
+    SwapAndPopColumn(animation.fps, index);
+    SwapAndPopColumn(animation.elapsedTime, index);
+
+    SwapAndPopColumn(render.spriteSheet, index);
+    SwapAndPopColumn(render.spriteWidth, index);
+    SwapAndPopColumn(render.spriteHeight, index);
+    SwapAndPopColumn(render.isSpriteless, index);
+    SwapAndPopColumn(render.spriteless, index);
+    SwapAndPopColumn(render.spritePath, index);
+
+    SwapAndPopColumn(contacts, index);
+}
+
+void EntityStorage::Clear() {
+    *this = EntityStorage();
+}
+
+void EntityStorage::Reserve(size_t capacity) {
+    ids.reserve(capacity);
+
+    transform.position.reserve(capacity);
+    transform.rotation.reserve(capacity);
+    transform.scale.reserve(capacity);
+    transform.flipX.reserve(capacity);
+    transform.flipY.reserve(capacity);
+
+    body.velocity.reserve(capacity);
+    body.acceleration.reserve(capacity);
+    body.mass.reserve(capacity);
+    body.drag.reserve(capacity);
+    body.physApplied.reserve(capacity);
+
+    collider.type.reserve(capacity);
+    collider.enabled.reserve(capacity);
+    collider.offset.reserve(capacity);
+    collider.size.reserve(capacity);
+    collider.frameSize.reserve(capacity);
+
+    animation.currentFrame.reserve(capacity);
+    animation.totalFrames.reserve(capacity);
+    animation.fps.reserve(capacity);
+    animation.elapsedTime.reserve(capacity);
+
+    render.spriteSheet.reserve(capacity);
+    render.spriteWidth.reserve(capacity);
+    render.spriteHeight.reserve(capacity);
+    render.isSpriteless.reserve(capacity);
+    render.spriteless.reserve(capacity);
+    render.spritePath.reserve(capacity);
+
+    contacts.reserve(capacity);
+}
+
+void EntityStorage::CopyPhysicsColumns(const EntityStorage& source) {
+    // Assigning into existing vectors reuses their capacity, so steady-state steps do not allocate
+    ids = source.ids;
+    transform.position = source.transform.position;
+    transform.scale = source.transform.scale;
+    body = source.body;
+    collider = source.collider;
+    contacts.resize(source.Size());
+}
+
+Vec2 EntityStorage::ComputeFrameSize(float spriteWidth, float spriteHeight, int totalFrames) {
+    float frameWidth = totalFrames > 1 ? (spriteWidth / static_cast<float>(totalFrames)) : spriteWidth;
+    return Vec2(frameWidth, spriteHeight);
+}
+
+}
@@ -0,0 +1,109 @@
+#ifndef ENTITYSTORAGE_H
+#define ENTITYSTORAGE_H
+
+#include "Entity.h"
+#include "Math/Math.h"
+#include <vector>
+#include <string>
+#include <utility>
+#include <cstdint>
+
+namespace RiverCore {
+
+// Collision records of a single entity (other entity ID, side)
+using ContactList = std::vector<std::pair<uint32_t, int>>;
+
+// Transform column group (read by physics, rendering and replication)
+struct TransformColumns {
+    std::vector<Vec2> position;
+    std::vector<float> rotation;
+    std::vector<Vec2> scale;
+    std::vector<uint8_t> flipX;        // uint8_t instead of bool to avoid vector<bool> bit packing
+    std::vector<uint8_t> flipY;
+};
+
+// Physics body column group (integrated by the physics step)
+struct BodyColumns {
+    std::vector<Vec2> velocity;
+    std::vector<Vec2> acceleration;
+    std::vector<float> mass;
+    std::vector<float> drag;
+    std::vector<uint8_t> physApplied;
+};
+
+// Collider bounds column group (read by the collision step)
+struct ColliderColumns {
+    std::vector<ColliderType> type;
+    std::vector<uint8_t> enabled;
+    std::vector<Vec2> offset;
+    std::vector<Vec2> size;
+    std::vector<Vec2> frameSize;       // Unscaled size of one sprite frame (AABB bounds and sprite source rect)
+};
+
+// Sprite animation column group
+struct AnimationColumns {
+    std::vector<int> currentFrame;
+    std::vector<int> totalFrames;
+    std::vector<float> fps;
+    std::vector<float> elapsedTime;
+};
+
+// Shape and color of a spriteless entity
+struct SpritelessShape {
+    float width = 10.0f;
+    float height = 10.0f;
+    uint8_t r = 255;
+    uint8_t g = 255;
+    uint8_t b = 255;
+    uint8_t a = 255;
+};
+
+// Render column group (read by the renderer only)
+struct RenderColumns {
+    std::vector<SDL_Texture*> spriteSheet;
+    std::vector<float> spriteWidth;
+    std::vector<float> spriteHeight;
+    std::vector<uint8_t> isSpriteless;
+    std::vector<SpritelessShape> spriteless;
+    std::vector<std::string> spritePath;   // Cold data, only needed for replication
+};
+
+// Column-oriented (structure-of-arrays) entity storage
+// Every column group is indexed by the same dense index, so each system only streams the columns it touches
+struct EntityStorage {
+    std::vector<uint32_t> ids;
+    TransformColumns transform;
+    BodyColumns body;
+    ColliderColumns collider;
+    AnimationColumns animation;
+    RenderColumns render;
+    std::vector<ContactList> contacts;
+
+    // Returns the number of stored entities
+    size_t Size() const { return ids.size(); }
+    // Returns whether the storage is empty
+    bool Empty() const { return ids.empty(); }
+
+    // Appends an entity by scattering its fields into the columns, returns its dense index
+    size_t Push(const Entity& entity);
+    // Gathers the entity at a dense index into an Entity record
+    Entity Load(size_t index) const;
+    // Scatters an Entity record into the columns at a dense index
+    void Store(size_t index, const Entity& entity);
+    // Removes the entity at a dense index by moving the last entity into its place
+    void SwapAndPop(size_t index);
+    // Removes all entities
+    void Clear();
+    // Reserves capacity in every column
+    void Reserve(size_t capacity);
+    // Copies only the columns the physics step reads and writes (IDs, position and scale, body, collider)
+    // Contact lists are sized but left to the physics step to fill, the other columns are not touched
+    void CopyPhysicsColumns(const EntityStorage& source);
+
+    // Computes the unscaled frame size used for collision bounds
+    static Vec2 ComputeFrameSize(float spriteWidth, float spriteHeight, int totalFrames);
+};
+
+}
+
+#endif
@@ -0,0 +1,18 @@
+#include "FrameState.h"
+
+namespace RiverCore {
+
+void FrameState::CopyFrom(const EntityStorage& storage) {
+    // Vector assignment reuses the destination's capacity (and the capacity of each sprite path string),
+    // so a recycled frame does not allocate once it has grown to the entity count
+    ids = storage.ids;
+    transform = storage.transform;
+    velocity = storage.body.velocity;
+    physApplied = storage.body.physApplied;
+    colliderType = storage.collider.type;
+    frameSize = storage.collider.frameSize;
+    animation = storage.animation;
+    render = storage.render;
+}
+
+}
@@ -0,0 +1,35 @@
+#ifndef FRAMESTATE_H
+#define FRAMESTATE_H
+
+#include "EntityStorage.h"
+#include <vector>
+#include <cstdint>
+
+namespace RiverCore {
+
+// Read-only snapshot of the entity columns, published once per simulation tick
+// Readers (renderer, server replication, replays) hold a shared reference to it instead of copying entities
+// under the entity mutex. Only the columns those readers need are captured (no contacts or forces).
+struct FrameState {
+    // Publish sequence number (increases by one with every published frame)
+    uint64_t frameNumber = 0;
+
+    std::vector<uint32_t> ids;
+    TransformColumns transform;
+    std::vector<Vec2> velocity;
+    std::vector<uint8_t> physApplied;
+    std::vector<ColliderType> colliderType;
+    std::vector<Vec2> frameSize;
+    AnimationColumns animation;
+    RenderColumns render;
+
+    // Returns the number of entities in the frame
+    size_t Size() const { return ids.size(); }
+
+    // Copies the published columns out of the entity storage, reusing this frame's existing capacity
+    void CopyFrom(const EntityStorage& storage);
+};
+
+}
+
+#endif
@@ -1,5 +1,6 @@
 #include "Renderer.h"
 #include <SDL3/SDL_log.h>
+#include <cmath>
 
 namespace RiverCore {
 
@@ -48,12 +49,14 @@ void Renderer::BeginFrame(float deltaTime, EntityManager& entityManager) {
     float globalScaleX, globalScaleY;
     CalculateScalingFactors(globalScaleX, globalScaleY);
 
-    // Get entities copy for rendering (thread-safe)
-    std::vector<Entity> entities = entityManager.GetEntitiesCopy();
+    // Render all entities from the latest published frame state (no copy, no entity lock)
+    std::shared_ptr<const FrameState> frame = entityManager.GetFrameState();
+    if (!frame) {
+        return; // Nothing published yet
+    }
 
-    // Render all entities
-    for (const auto& entity : entities) {
-        RenderEntity(entity, globalScaleX, globalScaleY);
+    for (size_t i = 0; i < frame->Size(); ++i) {
+        RenderEntity(*frame, i, globalScaleX, globalScaleY);
     }
 }
 
@@ -61,15 +64,20 @@ void Renderer::EndFrame() {
     SDL_RenderPresent(rendererRef);
 }
 
-void Renderer::RenderEntity(const Entity& entity, float globalScaleX, float globalScaleY) const {
+void Renderer::RenderEntity(const FrameState& frame, size_t index, float globalScaleX, float globalScaleY) const {
+    const Vec2& position = frame.transform.position[index];
+    const Vec2& scale = frame.transform.scale[index];
+
     // Handle spriteless entities
-    if (entity.isSpriteless) {
+    if (frame.render.isSpriteless[index]) {
+        const SpritelessShape& shape = frame.render.spriteless[index];
+
         // Calculate scaled dimensions
-        float scaledWidth = entity.spritelessWidth * entity.scale.x * globalScaleX;
-        float scaledHeight = entity.spritelessHeight * entity.scale.y * globalScaleY;
+        float scaledWidth = shape.width * scale.x * globalScaleX;
+        float scaledHeight = shape.height * scale.y * globalScaleY;
 
         // Apply camera transform to get camera-relative position
-        Vec2 cameraRelativePos = camera.ApplyCameraTransform(entity.position);
+        Vec2 cameraRelativePos = camera.ApplyCameraTransform(position);
 
         // Calculate screen position
         float finalXPos, finalYPos;
@@ -92,14 +100,14 @@ void Renderer::RenderEntity(const Entity& entity, float globalScaleX, float glob
         };
 
         // Set draw color with alpha
-        SDL_SetRenderDrawColor(rendererRef, entity.spritelessR, entity.spritelessG, entity.spritelessB, entity.spritelessA);
+        SDL_SetRenderDrawColor(rendererRef, shape.r, shape.g, shape.b, shape.a);
         SDL_SetRenderDrawBlendMode(rendererRef, SDL_BLENDMODE_BLEND);
 
         // Draw filled rectangle
         SDL_RenderFillRect(rendererRef, &rect);
 
         // Draw debug collision box if enabled
-        if (debugCollisions && entity.collider.type != ColliderType::NONE) {
+        if (debugCollisions && frame.colliderType[index] != ColliderType::NONE) {
             SDL_SetRenderDrawColor(rendererRef, 255, 0, 0, 255);
             SDL_RenderRect(rendererRef, &rect);
         }
@@ -108,29 +116,28 @@ void Renderer::RenderEntity(const Entity& entity, float globalScaleX, float glob
     }
 
     // Handle sprite entities
-    if (entity.spriteSheet == nullptr) return;
+    SDL_Texture* spriteSheet = frame.render.spriteSheet[index];
+    if (spriteSheet == nullptr) return;
 
-    float spriteWidth = entity.spriteWidth;
-
-    // Handle switching frames for animated entities
-    if(entity.totalFrames > 1) {
-        spriteWidth = entity.spriteWidth / static_cast<float>(entity.totalFrames);
-    }
+    // Frame size is precomputed per entity (sprite width split across animation frames)
+    const Vec2& frameSize = frame.frameSize[index];
+    float spriteWidth = frameSize.x;
+    float spriteHeight = frameSize.y;
 
     // Render the entity sprite to the screen
     SDL_FRect srcRect = {
-        (static_cast<float>(entity.currentFrame) * spriteWidth),
+        (static_cast<float>(frame.animation.currentFrame[index]) * spriteWidth),
         0.0f,
         spriteWidth,
-        entity.spriteHeight
+        spriteHeight
     };
 
     // Apply scaling mode calculations
-    float finalSpriteWidth = spriteWidth * entity.scale.x * globalScaleX;
-    float finalSpriteHeight = entity.spriteHeight * entity.scale.y * globalScaleY;
+    float finalSpriteWidth = spriteWidth * scale.x * globalScaleX;
+    float finalSpriteHeight = spriteHeight * scale.y * globalScaleY;
 
     // Apply camera transform to get camera-relative position (includes camera offset and zoom)
-    Vec2 cameraRelativePos = camera.ApplyCameraTransform(entity.position);
+    Vec2 cameraRelativePos = camera.ApplyCameraTransform(position);
 
     // Calculate sprite position with scaling mode consideration
     float finalXPos, finalYPos;
@@ -156,16 +163,18 @@ void Renderer::RenderEntity(const Entity& entity, float globalScaleX, float glob
 
     // Determine flip flags based on entity settings
     SDL_FlipMode flipMode = SDL_FLIP_NONE;
-    if (entity.flipX && entity.flipY) {
+    bool flipX = frame.transform.flipX[index] != 0;
+    bool flipY = frame.transform.flipY[index] != 0;
+    if (flipX && flipY) {
         flipMode = static_cast<SDL_FlipMode>(SDL_FLIP_HORIZONTAL | SDL_FLIP_VERTICAL);
-    } else if (entity.flipX) {
+    } else if (flipX) {
         flipMode = SDL_FLIP_HORIZONTAL;
-    } else if (entity.flipY) {
+    } else if (flipY) {
         flipMode = SDL_FLIP_VERTICAL;
     }
 
-    bool success = SDL_RenderTextureRotated(rendererRef, entity.spriteSheet, &srcRect, &dstRect,
-                                            entity.rotation, nullptr, flipMode);
+    bool success = SDL_RenderTextureRotated(rendererRef, spriteSheet, &srcRect, &dstRect,
+                                            frame.transform.rotation[index], nullptr, flipMode);
 
     if (!success) {
         SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Error rendering entity: %s\n", SDL_GetError());
@@ -173,15 +182,13 @@ void Renderer::RenderEntity(const Entity& entity, float globalScaleX, float glob
 
     if (debugCollisions) {
         // Calculate collision box dimensions
-        float frameWidth = entity.totalFrames > 1 ?
-            (entity.spriteWidth / static_cast<float>(entity.totalFrames)) : entity.spriteWidth;
-        float collisionWidth = frameWidth * abs(entity.scale.x);
-        float collisionHeight = entity.spriteHeight * abs(entity.scale.y);
+        float collisionWidth = frameSize.x * std::abs(scale.x);
+        float collisionHeight = frameSize.y * std::abs(scale.y);
 
         // Calculate world space collision bounds
         Vec2 worldCollisionPos = Vec2(
-            entity.position.x - (collisionWidth / 2.0f),
-            entity.position.y - (collisionHeight / 2.0f)
+            position.x - (collisionWidth / 2.0f),
+            position.y - (collisionHeight / 2.0f)
         );
 
         // Apply camera transform
@@ -61,8 +61,8 @@ private:
     // Camera for viewport transforms
     Camera camera;
 
-    // Function to render an entity
-    void RenderEntity(const Entity& entity, float globalScaleX, float globalScaleY) const;
+    // Function to render the entity at an index of a published frame state
+    void RenderEntity(const FrameState& frame, size_t index, float globalScaleX, float globalScaleY) const;
 };
 
 }
@@ -0,0 +1,154 @@
+#include "TextureCache.h"
+#include <SDL3/SDL_log.h>
+#include <SDL3_image/SDL_image.h>
+
+namespace RiverCore {
+
+TextureCache::~TextureCache() {
+    Clear();
+}
+
+void TextureCache::SetRenderer(SDL_Renderer* renderer) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    rendererRef = renderer;
+}
+
+void TextureCache::SetHeadlessMode(bool headless) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    headlessMode = headless;
+}
+
+TextureInfo TextureCache::Acquire(const std::string& spritePath) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+
+    // Reuse the cached sprite if it was already loaded (including one released but not yet collected)
+    auto it = entries.find(spritePath);
+    if (it != entries.end()) {
+        it->second.refCount++;
+        return it->second.info;
+    }
+
+    // First use: decode and upload once
+    TextureInfo info = LoadTexture(spritePath.c_str());
+    if (!info.texture && info.width == 0.0f && info.height == 0.0f) {
+        return info; // Failed loads are not cached so they can be retried
+    }
+
+    CacheEntry& entry = entries[spritePath];
+    entry.info = info;
+    entry.refCount = 1;
+    return info;
+}
+
+void TextureCache::Release(const std::string& spritePath, uint64_t lastFrame) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+
+    auto it = entries.find(spritePath);
+    if (it == entries.end() || it->second.refCount <= 0) {
+        return; // Not cached (spriteless entity or failed load)
+    }
+
+    // Keep the texture until no published frame can still draw it
+    if (--it->second.refCount == 0) {
+        it->second.releaseFrame = lastFrame;
+    }
+}
+
+void TextureCache::CollectUnused(uint64_t oldestFrameInUse) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->second.refCount == 0 && it->second.releaseFrame < oldestFrameInUse) {
+            if (it->second.info.texture != nullptr) {
+                SDL_DestroyTexture(it->second.info.texture);
+            }
+            it = entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void TextureCache::Clear() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+
+    for (auto& [path, entry] : entries) {
+        if (entry.info.texture != nullptr) {
+            SDL_DestroyTexture(entry.info.texture);
+        }
+    }
+    entries.clear();
+}
+
+int TextureCache::GetRefCount(const std::string& spritePath) const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+
+    auto it = entries.find(spritePath);
+    return it != entries.end() ? it->second.refCount : 0;
+}
+
+size_t TextureCache::GetCachedCount() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return entries.size();
+}
+
+TextureInfo TextureCache::LoadTexture(const char* spritePath) const {
+    TextureInfo result = {nullptr, 0.0f, 0.0f};
+
+    // In headless mode, skip texture loading but still get dimensions
+    if (headlessMode) {
+        // Load image to get dimensions (needed for physics/collisions)
+        SDL_Surface *spriteSheet = IMG_Load(spritePath);
+
+        if (!spriteSheet) {
+            SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Failed to load image %s: %s", spritePath, SDL_GetError());
+            return result;
+        }
+
+        // Get dimensions from the surface
+        result.width = static_cast<float>(spriteSheet->w);
+        result.height = static_cast<float>(spriteSheet->h);
+        result.texture = nullptr;  // No texture in headless mode
+
+        // Free the image surface
+        SDL_DestroySurface(spriteSheet);
+
+        return result;
+    }
+
+    // Normal mode: require renderer
+    if (!rendererRef) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Renderer not set in TextureCache");
+        return result;
+    }
+
+    // Load an image for the entity sprite
+    SDL_Surface *spriteSheet = IMG_Load(spritePath);
+
+    // Check if the image was loaded successfully
+    if (!spriteSheet) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Failed to load image %s: %s", spritePath, SDL_GetError());
+        return result;
+    }
+
+    // Get dimensions from the surface
+    result.width = static_cast<float>(spriteSheet->w);
+    result.height = static_cast<float>(spriteSheet->h);
+
+    // Create texture from the surface
+    result.texture = SDL_CreateTextureFromSurface(rendererRef, spriteSheet);
+
+    // Free the image surface after creating the texture
+    SDL_DestroySurface(spriteSheet);
+
+    if (!result.texture) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Failed to create texture: %s", SDL_GetError());
+        result.width = 0.0f;
+        result.height = 0.0f;
+        return result;
+    }
+
+    return result;
+}
+
+}
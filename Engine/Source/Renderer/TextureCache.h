@@ -0,0 +1,71 @@
+#ifndef TEXTURECACHE_H
+#define TEXTURECACHE_H
+
+#include <SDL3/SDL.h>
+#include <string>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+
+namespace RiverCore {
+
+// Struct to hold texture and its dimensions
+struct TextureInfo {
+    SDL_Texture* texture;
+    float width;
+    float height;
+};
+
+// Sprite asset cache keyed by path
+// Each image is decoded and uploaded once and shared between all entities using it. After the last release the
+// texture is kept until no published frame state can still reference it, then freed by CollectUnused
+class TextureCache {
+public:
+    TextureCache() = default;
+    ~TextureCache();
+
+    // Set renderer for texture uploads
+    void SetRenderer(SDL_Renderer* renderer);
+    // Set headless mode (only image dimensions are loaded, no textures are created)
+    void SetHeadlessMode(bool headless);
+
+    // Thread-safe function to acquire a reference to a sprite, loading it on first use
+    // Returns zero dimensions if the sprite could not be loaded (no reference is held in that case)
+    TextureInfo Acquire(const std::string& spritePath);
+    // Thread-safe function to release a reference to a sprite
+    // lastFrame is the newest published frame that may still reference the texture
+    void Release(const std::string& spritePath, uint64_t lastFrame);
+    // Thread-safe function to destroy unreferenced textures released before the oldest frame still in use
+    void CollectUnused(uint64_t oldestFrameInUse);
+    // Thread-safe function to release every reference and destroy all cached textures
+    void Clear();
+
+    // Thread-safe function to get the number of references held on a sprite
+    int GetRefCount(const std::string& spritePath) const;
+    // Thread-safe function to get the number of cached sprites
+    size_t GetCachedCount() const;
+
+private:
+    // Cached sprite and the number of entities referencing it
+    struct CacheEntry {
+        TextureInfo info = {nullptr, 0.0f, 0.0f};
+        int refCount = 0;
+        uint64_t releaseFrame = 0;     // Newest frame that may reference the texture once refCount reaches 0
+    };
+
+    // Mutex for thread-safe operations
+    mutable std::mutex cacheMutex;
+    // Map of sprite paths to cached sprites
+    std::unordered_map<std::string, CacheEntry> entries;
+    // Reference to the SDL renderer
+    SDL_Renderer* rendererRef = nullptr;
+    // Headless mode flag (no texture creation for server)
+    bool headlessMode = false;
+
+    // Function to decode an image and upload it as a texture
+    TextureInfo LoadTexture(const char* spritePath) const;
+};
+
+}
+
+#endif
@@ -167,20 +167,21 @@ GameStateSnapshot ReplayManager::CaptureGameState() {
     GameStateSnapshot snapshot;
     snapshot.timestamp = static_cast<uint64_t>(recordingTime * 1000.0f);
 
-    // Get all entities from the EntityManager
-    std::vector<Entity> entities = entityManager->GetEntitiesCopy();
+    // Publish a fresh frame so the keyframe includes changes made earlier this frame
+    std::shared_ptr<const FrameState> frame = entityManager->PublishFrameState();
 
     // Convert each entity to an EntitySnapshot
-    for (const Entity& entity : entities) {
+    snapshot.entities.reserve(frame->Size());
+    for (size_t i = 0; i < frame->Size(); ++i) {
         EntitySnapshot entitySnap;
-        entitySnap.entityID = entity.ID;
-        entitySnap.position = entity.position;
-        entitySnap.velocity = entity.velocity;
-        entitySnap.scale = entity.scale;
-        entitySnap.rotation = entity.rotation;
-        entitySnap.flipX = entity.flipX;
-        entitySnap.flipY = entity.flipY;
-        entitySnap.currentFrame = entity.currentFrame;
+        entitySnap.entityID = frame->ids[i];
+        entitySnap.position = frame->transform.position[i];
+        entitySnap.velocity = frame->velocity[i];
+        entitySnap.scale = frame->transform.scale[i];
+        entitySnap.rotation = frame->transform.rotation[i];
+        entitySnap.flipX = frame->transform.flipX[i] != 0;
+        entitySnap.flipY = frame->transform.flipY[i] != 0;
+        entitySnap.currentFrame = frame->animation.currentFrame[i];
 
         snapshot.entities.push_back(entitySnap);
     }
@@ -191,20 +192,16 @@ GameStateSnapshot ReplayManager::CaptureGameState() {
 void ReplayManager::RestoreGameState(const GameStateSnapshot& snapshot) {
     // Restore each entity's state from the snapshot
     for (const EntitySnapshot& entitySnap : snapshot.entities) {
-        if (entityManager->EntityExists(entitySnap.entityID)) {
-            // Update entity state
-            entityManager->SetPosition(entitySnap.entityID, entitySnap.position);
-            entityManager->FlipSprite(entitySnap.entityID, entitySnap.flipX, entitySnap.flipY);
-
-            // Get entity and update velocity directly
-            Entity* entity = entityManager->GetEntityByID(entitySnap.entityID);
-            if (entity) {
-                entity->velocity = entitySnap.velocity;
-                entity->rotation = entitySnap.rotation;
-                entity->scale = entitySnap.scale;
-                entity->currentFrame = entitySnap.currentFrame;
-            }
-        }
+        // Update entity state (skipped if the entity no longer exists)
+        entityManager->ModifyEntity(entitySnap.entityID, [&entitySnap](Entity& entity) {
+            entity.position = entitySnap.position;
+            entity.flipX = entitySnap.flipX;
+            entity.flipY = entitySnap.flipY;
+            entity.velocity = entitySnap.velocity;
+            entity.rotation = entitySnap.rotation;
+            entity.scale = entitySnap.scale;
+            entity.currentFrame = entitySnap.currentFrame;
+        });
     }
 }
 
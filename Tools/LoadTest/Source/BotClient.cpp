@@ -0,0 +1,104 @@
+#include "BotClient.h"
+#include <algorithm>
+#include <cmath>
+
+bool BotClient::Connect(const std::string& serverAddress) {
+    if (!client.Connect(serverAddress)) {
+        return false;
+    }
+
+    Clock::time_point now = Clock::now();
+    nextCommand = now;
+    ChangeInput(now);
+    return true;
+}
+
+void BotClient::Update(Clock::time_point now) {
+    if (!client.IsConnected()) {
+        return;
+    }
+
+    if (now >= nextInputChange) {
+        ChangeInput(now);
+    }
+
+    // Queue the commands due, skipping ahead rather than bursting if the bot fell behind
+    if (now - nextCommand > COMMAND_INTERVAL * 4) {
+        nextCommand = now;
+    }
+    while (nextCommand <= now) {
+        RiverCore::InputState command = input;
+        command.sequence = ++sequence;
+        command.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
+        client.QueueInputCommand(command);
+        commandTimes[sequence % commandTimes.size()] = now;
+        nextCommand += COMMAND_INTERVAL;
+    }
+
+    client.Update();
+
+    // Snapshot timestamps are the server's tick times on its clock, comparable as long as it runs on this machine
+    auto serverNow = std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(
+        std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+    std::vector<RiverCore::ReceivedSnapshot> snapshots = client.GetReceivedSnapshots();
+    size_t spawns = client.GetPendingSpawns().size();
+    size_t despawns = client.GetPendingDespawns().size();
+
+    std::lock_guard<std::mutex> lock(samplesMutex);
+    pending.spawns += spawns;
+    pending.despawns += despawns;
+    for (const RiverCore::ReceivedSnapshot& received : snapshots) {
+        ++pending.snapshots;
+
+        double waitedMs = std::chrono::duration<double, std::milli>(now - received.receivedAt).count();
+        pending.snapshotAgesMs.push_back(
+            static_cast<float>(serverNow - waitedMs - static_cast<double>(received.snapshot->timestamp)));
+
+        // The ack repeats until the server applies a newer command, only its first arrival is a reply
+        if (received.inputAck > lastAck && sequence - received.inputAck < commandTimes.size()) {
+            Clock::time_point queuedAt = commandTimes[received.inputAck % commandTimes.size()];
+            pending.replyLatenciesMs.push_back(
+                std::chrono::duration<float, std::milli>(received.receivedAt - queuedAt).count());
+        }
+        lastAck = std::max(lastAck, received.inputAck);
+    }
+}
+
+void BotClient::CollectSamples(BotSamples& samples) {
+    uint64_t sent = client.GetBytesSent();
+    uint64_t received = client.GetBytesReceived();
+
+    std::lock_guard<std::mutex> lock(samplesMutex);
+    samples.snapshotAgesMs.insert(samples.snapshotAgesMs.end(), pending.snapshotAgesMs.begin(),
+                                  pending.snapshotAgesMs.end());
+    samples.replyLatenciesMs.insert(samples.replyLatenciesMs.end(), pending.replyLatenciesMs.begin(),
+                                    pending.replyLatenciesMs.end());
+    samples.snapshots += pending.snapshots;
+    samples.spawns += pending.spawns;
+    samples.despawns += pending.despawns;
+    pending = BotSamples();
+
+    // Counters restart from zero on reconnect
+    samples.bytesSent += sent >= collectedBytesSent ? sent - collectedBytesSent : sent;
+    samples.bytesReceived += received >= collectedBytesReceived ? received - collectedBytesReceived : received;
+    collectedBytesSent = sent;
+    collectedBytesReceived = received;
+}
+
+void BotClient::ChangeInput(Clock::time_point now) {
+    // One of eight headings, or standing still, for a quarter to a full second
+    std::uniform_int_distribution<int> heading(-1, 7);
+    std::uniform_int_distribution<int> holdMs(250, 1000);
+    std::bernoulli_distribution fire(0.2);
+
+    input = RiverCore::InputState();
+    int choice = heading(random);
+    if (choice >= 0) {
+        float angle = static_cast<float>(choice) * 3.14159265f / 4.0f;
+        input.SetAxis(actions.moveX, std::cos(angle));
+        input.SetAxis(actions.moveY, std::sin(angle));
+    }
+    input.SetButton(actions.fire, fire(random));
+
+    nextInputChange = now + std::chrono::milliseconds(holdMs(random));
+}
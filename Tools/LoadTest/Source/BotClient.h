@@ -0,0 +1,76 @@
+#ifndef BOTCLIENT_H
+#define BOTCLIENT_H
+
+#include "Networking/Client.h"
+#include "LoadTestGame.h"
+#include <array>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+// Measurements gathered from the bots over a reporting interval
+struct BotSamples {
+    std::vector<float> snapshotAgesMs;      // Server tick time to arrival of each snapshot
+    std::vector<float> replyLatenciesMs;    // Input command queued to the snapshot acknowledging it
+    uint64_t bytesSent = 0;
+    uint64_t bytesReceived = 0;
+    uint64_t snapshots = 0;
+    uint64_t spawns = 0;
+    uint64_t despawns = 0;
+};
+
+// Scripted client for load tests
+// Connects through the real Client, so it speaks the same protocol as the game, and streams one randomized
+// input command per server tick the way a predicting client does
+class BotClient {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    BotClient(const LoadTestActions& actions, uint32_t seed) : actions(actions), random(seed) {}
+
+    // Connects to a server (blocks for the handshake)
+    bool Connect(const std::string& serverAddress);
+    // Disconnects from the server
+    void Disconnect() { client.Disconnect(); }
+    // Simulates network conditions on the bot's connection
+    void SetNetworkConditions(const RiverCore::NetworkConditions& conditions) { client.SetNetworkConditions(conditions); }
+    // Returns if the bot is connected
+    bool IsConnected() const { return client.IsConnected(); }
+
+    // Issues the input commands due by a point in time, then sends and receives everything pending
+    void Update(Clock::time_point now);
+    // Moves the measurements taken since the last call into samples
+    void CollectSamples(BotSamples& samples);
+
+private:
+    RiverCore::Client client;
+    LoadTestActions actions;
+    std::mt19937 random;
+
+    // Current scripted input and when it changes next
+    RiverCore::InputState input;
+    Clock::time_point nextInputChange;
+
+    // Command timing
+    Clock::time_point nextCommand;
+    uint32_t sequence = 0;
+    // Queue time of recent commands, by sequence
+    std::array<Clock::time_point, 256> commandTimes{};
+    uint32_t lastAck = 0;
+
+    // Measurements not collected yet
+    BotSamples pending;
+    uint64_t collectedBytesSent = 0;
+    uint64_t collectedBytesReceived = 0;
+    std::mutex samplesMutex;
+
+    // Time between input commands, one per server tick
+    static constexpr std::chrono::microseconds COMMAND_INTERVAL{16667};
+
+    // Picks a new random heading (or standing still)
+    void ChangeInput(Clock::time_point now);
+};
+
+#endif
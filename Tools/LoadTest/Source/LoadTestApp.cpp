@@ -0,0 +1,309 @@
+#include "BotClient.h"
+#include "LoadTestGame.h"
+#include "Networking/Server.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct LoadTestOptions {
+    int clients = 64;               // Bots to connect
+    float rampSeconds = 5.0f;       // Time over which the bots connect
+    float durationSeconds = 30.0f;  // Length of the run, including the ramp
+    float reportSeconds = 1.0f;     // Interval between report lines
+    int threads = 4;                // Threads driving the bots
+    std::string address;            // External server to load (empty = run one in this process)
+    int entities = 0;               // Wandering entities in the in-process server's world
+    float worldSize = 4096.0f;      // Side of the square the in-process server spreads entities over
+    float interestRadius = 0.0f;    // Area of interest radius of the in-process server (0 = disabled)
+    int networkWorkers = 1;         // Encoding threads of the in-process server
+    float bandwidthBudget = 0.0f;   // Entity update bytes per second per client of the in-process server (0 = unlimited)
+    RiverCore::NetworkConditions conditions;  // Network simulated on every bot's connection
+};
+
+void PrintUsage() {
+    std::cout << "Usage: RiverLoadTest [options]\n"
+              << "  --clients N        bots to connect (default 64)\n"
+              << "  --ramp SECONDS     time over which the bots connect (default 5)\n"
+              << "  --duration SECONDS length of the run (default 30)\n"
+              << "  --report SECONDS   interval between report lines (default 1)\n"
+              << "  --threads N        threads driving the bots (default 4)\n"
+              << "  --address HOST     load an external server instead of one run in this process\n"
+              << "                     (tick times are only known in-process, snapshot ages need the same machine)\n"
+              << "  --entities N       wandering entities in the in-process world (default 0)\n"
+              << "  --world SIZE       side of the in-process world (default 4096)\n"
+              << "  --interest RADIUS  in-process area of interest radius (default 0, disabled)\n"
+              << "  --budget BYTES     in-process entity update bytes per second per client (default 0, unlimited)\n"
+              << "  --workers N        in-process network encoding threads (default 1)\n"
+              << "  --netsim SPEC      simulate a network on every bot, e.g. delay=80,jitter=20,drop=0.02,\n"
+              << "                     reorder=0.01,bandwidth=32000,seed=7,log=netsim.log (each bot logs to\n"
+              << "                     its own file and draws from seed plus its index)\n";
+}
+
+bool ParseOptions(int argc, char* argv[], LoadTestOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help") {
+            return false;
+        }
+        if (i + 1 >= argc) {
+            std::cout << "Missing value for " << arg << "\n";
+            return false;
+        }
+
+        std::string value = argv[++i];
+        try {
+            if (arg == "--clients") options.clients = std::stoi(value);
+            else if (arg == "--ramp") options.rampSeconds = std::stof(value);
+            else if (arg == "--duration") options.durationSeconds = std::stof(value);
+            else if (arg == "--report") options.reportSeconds = std::stof(value);
+            else if (arg == "--threads") options.threads = std::stoi(value);
+            else if (arg == "--address") options.address = value;
+            else if (arg == "--entities") options.entities = std::stoi(value);
+            else if (arg == "--world") options.worldSize = std::stof(value);
+            else if (arg == "--interest") options.interestRadius = std::stof(value);
+            else if (arg == "--workers") options.networkWorkers = std::stoi(value);
+            else if (arg == "--budget") options.bandwidthBudget = std::stof(value);
+            else if (arg == "--netsim") {
+                if (!RiverCore::NetworkConditions::Parse(value, options.conditions)) {
+                    std::cout << "Invalid network conditions: " << value << "\n";
+                    return false;
+                }
+            }
+            else {
+                std::cout << "Unknown argument: " << arg << "\n";
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cout << "Invalid value for " << arg << ": " << value << "\n";
+            return false;
+        }
+    }
+
+    options.clients = std::max(options.clients, 1);
+    options.threads = std::clamp(options.threads, 1, options.clients);
+    options.reportSeconds = std::max(options.reportSeconds, 0.1f);
+    return true;
+}
+
+// Value below which a fraction of the samples fall (sorts the samples)
+float Percentile(std::vector<float>& samples, float fraction) {
+    if (samples.empty()) {
+        return 0.0f;
+    }
+    std::sort(samples.begin(), samples.end());
+    size_t index = static_cast<size_t>(fraction * static_cast<float>(samples.size() - 1) + 0.5f);
+    return samples[std::min(index, samples.size() - 1)];
+}
+
+// Drives a slice of the bots: connects each at its point in the ramp, then updates them every tick
+void DriveBots(std::vector<std::unique_ptr<BotClient>>& bots, size_t begin, size_t end, const LoadTestOptions& options,
+               BotClient::Clock::time_point start, const std::atomic<bool>& running) {
+    auto connectAt = [&](size_t i) {
+        auto offset = std::chrono::duration<float>(options.rampSeconds * static_cast<float>(i) /
+                                                   static_cast<float>(options.clients));
+        return start + std::chrono::duration_cast<BotClient::Clock::duration>(offset);
+    };
+    const std::string address = options.address.empty() ? "localhost" : options.address;
+
+    size_t nextConnect = begin;
+    while (running.load()) {
+        auto now = BotClient::Clock::now();
+        while (nextConnect < end && connectAt(nextConnect) <= now) {
+            if (!bots[nextConnect]->Connect(address)) {
+                std::cout << "Bot " << nextConnect << " failed to connect\n";
+            }
+            ++nextConnect;
+        }
+
+        now = BotClient::Clock::now();
+        for (size_t i = begin; i < nextConnect; ++i) {
+            bots[i]->Update(now);
+        }
+
+        std::this_thread::sleep_until(now + std::chrono::milliseconds(4));
+    }
+
+    for (size_t i = begin; i < end; ++i) {
+        bots[i]->Disconnect();
+    }
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    using namespace RiverCore;
+
+    LoadTestOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        PrintUsage();
+        return 1;
+    }
+
+    // Start a server in this process unless an external one is loaded
+    std::unique_ptr<Server> server;
+    std::unique_ptr<LoadTestGame> game;
+    std::thread serverThread;
+    if (options.address.empty()) {
+        server = std::make_unique<Server>();
+        game = std::make_unique<LoadTestGame>(options.entities, options.worldSize);
+
+        game->SetEntityManager(&server->GetEntityManager());
+        game->SetPhysicsRef(&server->GetPhysics());
+        game->SetTimeline(&server->GetTimeline());
+        game->SetInputManager(&server->GetInputManager());
+        game->SetEventManager(&server->GetEventManager());
+        game->SetMode(NetworkMode::SERVER);
+        game->SetServerRef(server.get());
+        game->SetHeadlessServer(true);
+        server->GetEntityManager().SetHeadlessMode(true);
+
+        InterestArea interest;
+        interest.radius = options.interestRadius;
+        server->SetInterestArea(interest);
+        BandwidthBudget budget;
+        budget.bytesPerSecond = options.bandwidthBudget;
+        server->SetBandwidthBudget(budget);
+        server->SetNetworkWorkerCount(static_cast<size_t>(std::max(options.networkWorkers, 1)));
+
+        game->OnStart();
+        serverThread = std::thread([&server, &game]() { server->Start(game.get()); });
+
+        // Give the server time to bind its socket
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+
+    // Registered in the same order as the server's (a second registration returns the same IDs)
+    LoadTestActions actions = LoadTestActions::Register();
+    std::vector<std::unique_ptr<BotClient>> bots;
+    for (int i = 0; i < options.clients; ++i) {
+        bots.push_back(std::make_unique<BotClient>(actions, 1000u + static_cast<uint32_t>(i)));
+
+        // Every bot gets its own draws (two per bot, one for each direction) and log
+        if (options.conditions.IsEnabled()) {
+            NetworkConditions conditions = options.conditions;
+            conditions.seed += static_cast<uint32_t>(i) * 2;
+            if (!conditions.logPath.empty()) {
+                conditions.logPath += "." + std::to_string(i);
+            }
+            bots.back()->SetNetworkConditions(conditions);
+        }
+    }
+
+    std::cout << "Load test: " << options.clients << " bots over " << options.rampSeconds << " s, "
+              << options.durationSeconds << " s total, against "
+              << (options.address.empty() ? "an in-process server" : options.address) << "\n";
+    std::cout << "  time clients | tick ms p50/p95/p99/max  over | down KB/s/client up | age ms p50/p95 | reply ms p50/p95\n";
+
+    // Drive the bots across the threads
+    std::atomic<bool> running{true};
+    auto start = BotClient::Clock::now();
+    std::vector<std::thread> drivers;
+    size_t perThread = (bots.size() + options.threads - 1) / options.threads;
+    for (size_t begin = 0; begin < bots.size(); begin += perThread) {
+        size_t end = std::min(begin + perThread, bots.size());
+        drivers.emplace_back(DriveBots, std::ref(bots), begin, end, std::cref(options), start, std::cref(running));
+    }
+
+    const float budgetMs = Server::GetFixedTimestep() * 1000.0f;
+    std::vector<float> allTicks;
+    BotSamples total;
+    int capacity = 0;
+    auto lastReport = start;
+    auto end = start + std::chrono::duration_cast<BotClient::Clock::duration>(
+        std::chrono::duration<float>(options.durationSeconds));
+
+    while (BotClient::Clock::now() < end) {
+        std::this_thread::sleep_until(std::min(end, lastReport + std::chrono::duration_cast<BotClient::Clock::duration>(
+            std::chrono::duration<float>(options.reportSeconds))));
+        auto now = BotClient::Clock::now();
+        float interval = std::chrono::duration<float>(now - lastReport).count();
+        lastReport = now;
+
+        BotSamples samples;
+        int connected = 0;
+        for (const auto& bot : bots) {
+            bot->CollectSamples(samples);
+            connected += bot->IsConnected() ? 1 : 0;
+        }
+        std::vector<float> ticks;
+        if (server) {
+            for (float seconds : server->GetTickDurations()) {
+                ticks.push_back(seconds * 1000.0f);
+            }
+        }
+        size_t overBudget = std::count_if(ticks.begin(), ticks.end(), [budgetMs](float ms) { return ms > budgetMs; });
+
+        total.bytesSent += samples.bytesSent;
+        total.bytesReceived += samples.bytesReceived;
+        total.snapshots += samples.snapshots;
+        total.snapshotAgesMs.insert(total.snapshotAgesMs.end(), samples.snapshotAgesMs.begin(), samples.snapshotAgesMs.end());
+        total.replyLatenciesMs.insert(total.replyLatenciesMs.end(), samples.replyLatenciesMs.begin(),
+                                      samples.replyLatenciesMs.end());
+        allTicks.insert(allTicks.end(), ticks.begin(), ticks.end());
+
+        float tickP50 = Percentile(ticks, 0.5f);
+        float tickP95 = Percentile(ticks, 0.95f);
+        float tickP99 = Percentile(ticks, 0.99f);
+        float tickMax = ticks.empty() ? 0.0f : ticks.back();
+
+        // Capacity is the most clients an interval kept 99% of its ticks within the timestep with
+        if (!ticks.empty() && tickP99 <= budgetMs) {
+            capacity = std::max(capacity, connected);
+        }
+
+        float ageP50 = Percentile(samples.snapshotAgesMs, 0.5f);
+        float ageP95 = Percentile(samples.snapshotAgesMs, 0.95f);
+        float replyP50 = Percentile(samples.replyLatenciesMs, 0.5f);
+        float replyP95 = Percentile(samples.replyLatenciesMs, 0.95f);
+        float perClient = connected > 0 ? interval * static_cast<float>(connected) : 1.0f;
+        std::printf("%6.1f %7d | %5.2f %5.2f %5.2f %6.2f %5zu | %9.2f %6.2f | %6.1f %6.1f | %6.1f %6.1f\n",
+                    std::chrono::duration<float>(now - start).count(), connected,
+                    tickP50, tickP95, tickP99, tickMax, overBudget,
+                    samples.bytesReceived / 1024.0f / perClient, samples.bytesSent / 1024.0f / perClient,
+                    ageP50, ageP95, replyP50, replyP95);
+        std::fflush(stdout);
+    }
+
+    running = false;
+    for (std::thread& driver : drivers) {
+        driver.join();
+    }
+
+    if (server) {
+        server->Stop();
+        serverThread.join();
+    }
+
+    // Summary over the whole run
+    float seconds = std::chrono::duration<float>(BotClient::Clock::now() - start).count();
+    std::printf("\nSummary over %.1f s with %d bots\n", seconds, options.clients);
+    if (!allTicks.empty()) {
+        size_t overBudget = std::count_if(allTicks.begin(), allTicks.end(), [budgetMs](float ms) { return ms > budgetMs; });
+        float tickP50 = Percentile(allTicks, 0.5f);
+        float tickP95 = Percentile(allTicks, 0.95f);
+        float tickP99 = Percentile(allTicks, 0.99f);
+        std::printf("  tick ms      p50 %.2f  p95 %.2f  p99 %.2f  max %.2f  (%zu of %zu over %.2f ms)\n",
+                    tickP50, tickP95, tickP99, allTicks.back(), overBudget, allTicks.size(), budgetMs);
+        std::printf("  capacity     %d clients with p99 tick within the timestep\n", capacity);
+    }
+    std::printf("  traffic      %.2f KB/s down, %.2f KB/s up per client (average)\n",
+                total.bytesReceived / 1024.0f / seconds / options.clients,
+                total.bytesSent / 1024.0f / seconds / options.clients);
+    float ageP50 = Percentile(total.snapshotAgesMs, 0.5f);
+    float ageP95 = Percentile(total.snapshotAgesMs, 0.95f);
+    float ageP99 = Percentile(total.snapshotAgesMs, 0.99f);
+    std::printf("  snapshot age p50 %.1f  p95 %.1f  p99 %.1f ms (%llu snapshots)\n",
+                ageP50, ageP95, ageP99, static_cast<unsigned long long>(total.snapshots));
+    float replyP50 = Percentile(total.replyLatenciesMs, 0.5f);
+    float replyP95 = Percentile(total.replyLatenciesMs, 0.95f);
+    float replyP99 = Percentile(total.replyLatenciesMs, 0.99f);
+    std::printf("  reply        p50 %.1f  p95 %.1f  p99 %.1f ms\n", replyP50, replyP95, replyP99);
+    return 0;
+}
@@ -0,0 +1,138 @@
+#ifndef LOADTESTGAME_H
+#define LOADTESTGAME_H
+
+#include "GameInterface.h"
+#include <unordered_map>
+#include <vector>
+#include <random>
+#include <mutex>
+#include <cmath>
+
+// Input actions shared by the bots and the load test server (registered in this order on both)
+struct LoadTestActions {
+    RiverCore::InputActionID moveX;
+    RiverCore::InputActionID moveY;
+    RiverCore::InputActionID fire;
+
+    static LoadTestActions Register() {
+        LoadTestActions actions;
+        actions.moveX = RiverCore::InputActions::RegisterAxis("moveX");
+        actions.moveY = RiverCore::InputActions::RegisterAxis("moveY");
+        actions.fire = RiverCore::InputActions::RegisterButton("fire");
+        return actions;
+    }
+};
+
+// Server game logic for load tests: a top-down world where every client gets a player entity moved by its
+// input, plus wandering entities to give the snapshots some bulk
+class LoadTestGame : public RiverCore::GameInterface {
+public:
+    LoadTestGame(int wanderingEntities, float worldSize)
+        : wanderingCount(wanderingEntities), worldSize(worldSize) {}
+
+    void OnStart() override {
+        actions = LoadTestActions::Register();
+        SetGravity(0.0f);
+
+        for (int i = 0; i < wanderingCount; ++i) {
+            Vec2 position = RandomPosition(random);
+            uint32_t entityID = AddSpritelessEntity(16.0f, 16.0f, 200, 200, 200, 255, position.x, position.y,
+                                                    0.0f, 1.0f, 1.0f, true);
+            if (entityID != 0) {
+                wanderers.push_back(entityID);
+            }
+        }
+    }
+
+    void OnUpdate(float deltaTime) override {
+        // Pick new headings once a second, turning back towards the middle at the edges
+        wanderTimer += deltaTime;
+        if (wanderTimer < 1.0f) {
+            return;
+        }
+        wanderTimer = 0.0f;
+
+        std::uniform_real_distribution<float> speed(-WANDER_SPEED, WANDER_SPEED);
+        for (uint32_t entityID : wanderers) {
+            Vec2 position = GetPosition(entityID);
+            Vec2 velocity(speed(random), speed(random));
+            if (std::abs(position.x) > worldSize * 0.5f) {
+                velocity.x = position.x > 0.0f ? -WANDER_SPEED : WANDER_SPEED;
+            }
+            if (std::abs(position.y) > worldSize * 0.5f) {
+                velocity.y = position.y > 0.0f ? -WANDER_SPEED : WANDER_SPEED;
+            }
+            SetVelocity(entityID, velocity.x, velocity.y);
+        }
+    }
+
+    bool OnPlayerInput(uint32_t entityID, const RiverCore::InputState& input, float /*deltaTime*/) override {
+        float speed = input.IsPressed(actions.fire) ? PLAYER_SPEED * 2.0f : PLAYER_SPEED;
+        SetVelocity(entityID, input.GetAxis(actions.moveX) * speed, input.GetAxis(actions.moveY) * speed);
+        return true;
+    }
+
+    void OnClientConnected(uint32_t clientID) override {
+        Vec2 position;
+        {
+            std::lock_guard<std::mutex> lock(playersMutex);
+            position = RandomPosition(spawnRandom);
+        }
+
+        uint32_t entityID = AddSpritelessEntity(24.0f, 24.0f, 80, 160, 255, 255, position.x, position.y,
+                                                0.0f, 1.0f, 1.0f, true);
+        if (entityID == 0) {
+            return;
+        }
+
+        RegisterPlayerEntity(clientID, entityID);
+        BroadcastEntitySpawn(entityID, clientID);
+
+        std::lock_guard<std::mutex> lock(playersMutex);
+        players[clientID] = entityID;
+    }
+
+    void OnClientDisconnected(uint32_t clientID) override {
+        uint32_t entityID = 0;
+        {
+            std::lock_guard<std::mutex> lock(playersMutex);
+            auto it = players.find(clientID);
+            if (it == players.end()) {
+                return;
+            }
+            entityID = it->second;
+            players.erase(it);
+        }
+
+        // The server already removed the entity, the other clients still need to be told
+        BroadcastEntityDespawn(entityID);
+    }
+
+private:
+    using Vec2 = RiverCore::Vec2;
+
+    int wanderingCount;
+    float worldSize;
+    LoadTestActions actions{};
+
+    std::vector<uint32_t> wanderers;
+    float wanderTimer = 0.0f;
+
+    // Player entity of each client (clients connect on the network thread)
+    std::unordered_map<uint32_t, uint32_t> players;
+    std::mutex playersMutex;
+
+    // Fixed seeds, so runs place entities the same way
+    std::mt19937 random{12345};         // Simulation thread
+    std::mt19937 spawnRandom{67890};    // Guarded by playersMutex
+
+    static constexpr float PLAYER_SPEED = 200.0f;
+    static constexpr float WANDER_SPEED = 120.0f;
+
+    Vec2 RandomPosition(std::mt19937& generator) const {
+        std::uniform_real_distribution<float> coordinate(-worldSize * 0.5f, worldSize * 0.5f);
+        return Vec2(coordinate(generator), coordinate(generator));
+    }
+};
+
+#endif